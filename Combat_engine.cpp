@@ -0,0 +1,131 @@
+#include "Combat_engine.h"
+#include "Ship.h"
+#include "Ship_state_store.h"
+#include "Model.h"
+#include "Geometry.h"
+#include <cassert>
+
+using namespace std;
+
+// how far a ship may be from its predicted position when an attacker fires at it;
+// docking shifts a ship by up to the docking distance of .1 nm after its move
+const double COMBAT_RANGE_MARGIN = .5;
+
+Combat_engine* Combat_engine::engine = 0;
+
+Combat_engine* Combat_engine::get_Instance()
+{
+    if (!engine) engine = new Combat_engine;
+    return engine;
+}
+
+// record that the ship in attacker_slot attacks the one in target_slot
+void Combat_engine::engage(int attacker_slot, int target_slot, double range, bool target_first)
+{
+    if (attacker_slot >= int(slot_engagements.size())) slot_engagements.resize(attacker_slot + 1, -1);
+    int engagement = slot_engagements[attacker_slot];
+    if (engagement < 0)
+    {
+        engagement = get_engagement_count();
+        slot_engagements[attacker_slot] = engagement;
+        attacker_slots.push_back(attacker_slot);
+        target_slots.push_back(0);
+        ranges.push_back(0.);
+        targets_first.push_back(0);
+        resolutions.push_back(UNDECIDED);
+    }
+    target_slots[engagement] = target_slot;
+    ranges[engagement] = range;
+    targets_first[engagement] = target_first;
+    resolutions[engagement] = UNDECIDED;
+}
+
+// forget the engagement of the ship in the slot, moving the last engagement into its place
+void Combat_engine::disengage(int attacker_slot)
+{
+    if (attacker_slot >= int(slot_engagements.size()) || slot_engagements[attacker_slot] < 0) return;
+    int engagement = slot_engagements[attacker_slot];
+    int last = get_engagement_count() - 1;
+    slot_engagements[attacker_slots[last]] = engagement;
+    attacker_slots[engagement] = attacker_slots[last];
+    target_slots[engagement] = target_slots[last];
+    ranges[engagement] = ranges[last];
+    targets_first[engagement] = targets_first[last];
+    resolutions[engagement] = resolutions[last];
+    slot_engagements[attacker_slot] = -1;
+    attacker_slots.pop_back();
+    target_slots.pop_back();
+    ranges.pop_back();
+    targets_first.pop_back();
+    resolutions.pop_back();
+}
+
+// resolve the engagements in [begin, end); a distance within the margin of the range
+// is left undecided
+void Combat_engine::resolve_ranges(int begin, int end)
+{
+    Ship_state_store* store = Ship_state_store::get_Instance();
+    for (int i = begin; i < end; i++)
+    {
+        Point attacker_position = store->get_moved_position(attacker_slots[i]);
+        Point target_position = targets_first[i] ? store->get_moved_position(target_slots[i])
+                : store->get_position(target_slots[i]);
+        double distance = cartesian_distance(attacker_position, target_position);
+        if (distance < ranges[i] - COMBAT_RANGE_MARGIN) resolutions[i] = IN_RANGE;
+        else if (distance >= ranges[i] + COMBAT_RANGE_MARGIN) resolutions[i] = OUT_OF_RANGE;
+        else resolutions[i] = UNDECIDED;
+    }
+}
+
+// return true if the target of the ship in the slot is in range of it now
+bool Combat_engine::is_target_in_range(int attacker_slot) const
+{
+    assert(attacker_slot < int(slot_engagements.size()) && slot_engagements[attacker_slot] >= 0);
+    int engagement = slot_engagements[attacker_slot];
+    if (resolved && resolutions[engagement] != UNDECIDED) return resolutions[engagement] == IN_RANGE;
+    Ship_state_store* store = Ship_state_store::get_Instance();
+    return cartesian_distance(store->get_position(attacker_slot), store->get_position(target_slots[engagement]))
+            < ranges[engagement];
+}
+
+// the target receives a hit of the supplied force from the attacker
+void Combat_engine::fire(shared_ptr<Ship> attacker, shared_ptr<Ship> target, int hit_force)
+{
+    actions.push_back(Combat_action{true, target, attacker, hit_force});
+    apply_actions();
+}
+
+// the ship attacks the one that hit it, once the hits before have been applied
+void Combat_engine::retaliate(shared_ptr<Ship> ship, shared_ptr<Ship> attacker)
+{
+    actions.push_back(Combat_action{false, ship, attacker, 0});
+    apply_actions();
+}
+
+// apply the queued actions in order; an action queued while one is being applied
+// is left for the loop that is already running
+void Combat_engine::apply_actions()
+{
+    if (applying_actions) return;
+    applying_actions = true;
+    try
+    {
+        while (!actions.empty())
+        {
+            Combat_action action = actions.front();
+            actions.pop_front();
+            Model::get_Instance()->bring_up_to_date(*action.subject);
+            if (action.is_hit) action.subject->receive_hit(action.hit_force, action.other);
+            else action.subject->attack(action.other);
+            // the action may change what the subject does next
+            Model::get_Instance()->reschedule(action.subject->get_name());
+        }
+    }
+    catch (...)
+    {
+        actions.clear();
+        applying_actions = false;
+        throw;
+    }
+    applying_actions = false;
+}
@@ -0,0 +1,105 @@
+#ifndef COMBAT_ENGINE_H
+#define COMBAT_ENGINE_H
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+class Ship;
+
+/* Combat_engine
+The Combat_engine keeps the engagement of every attacking Warship - the slots of the
+attacker and its target in the Ship_state_store, and the range of its weapons - in
+contiguous arrays, and at the start of each tick it decides for all of them in one pass
+whether the target will be in range when the attacker fires, instead of each attacker
+looking up its target and both positions on its own.
+
+Ships move one at a time in name order, so an attacker fires from where it is after its
+own move, at a target that has already moved if it comes first by name, and has not
+if it comes later. The engine predicts those positions from the moves pending in the
+store. A ship that docks is shifted a little after its move, so an engagement whose
+predicted distance is that near the range is left undecided and checked directly.
+Model::run_until does not resolve the engagements, because it does not advance every
+target in every hour, so there each attacker checks its target directly.
+
+Hits, and the retaliation they provoke, are put in a queue that a single loop works
+off in order, so a hit never leads to a nested chain of calls, and every hit is applied
+in the order in which it was fired. Like the Model, there is only one Combat_engine.
+*/
+
+class Combat_engine {
+public:
+    static Combat_engine* get_Instance();
+
+    // record that the ship in attacker_slot attacks the one in target_slot, replacing any
+    // engagement it had; target_first is true if the target is updated before the attacker
+    void engage(int attacker_slot, int target_slot, double range, bool target_first);
+    // forget the engagement of the ship in the slot, if it has one
+    void disengage(int attacker_slot);
+
+    int get_engagement_count() const
+        {return int(attacker_slots.size());}
+
+    /*** Range checks ***/
+    // decide whether the target of each engagement will be in range when its attacker
+    // is updated in this tick; the moves of the tick must not have been committed yet
+    void resolve_ranges()
+    {
+        resolve_ranges(0, get_engagement_count());
+        set_resolved();
+    }
+    // resolve the engagements in [begin, end); if every pending move has already been
+    // computed, calls for separate ranges touch separate data, so they may run in parallel.
+    // The resolutions are used only once set_resolved is called after all of the calls.
+    void resolve_ranges(int begin, int end);
+    void set_resolved()
+        {resolved = true;}
+    // discard the resolutions at the end of the tick
+    void discard_resolutions()
+        {resolved = false;}
+    // return true if the target of the ship in the slot, which must be engaged,
+    // is in range of it now; the resolution is used if there is one
+    bool is_target_in_range(int attacker_slot) const;
+
+    /*** Hits ***/
+    // the target receives a hit of the supplied force from the attacker; the hit, and
+    // anything it provokes, has been applied when this returns
+    void fire(std::shared_ptr<Ship> attacker, std::shared_ptr<Ship> target, int hit_force);
+    // the ship attacks the one that hit it, once the hits before have been applied
+    void retaliate(std::shared_ptr<Ship> ship, std::shared_ptr<Ship> attacker);
+
+    // disallow copy/move construction or assignment
+    Combat_engine(const Combat_engine&) = delete;
+    Combat_engine& operator=(const Combat_engine&) = delete;
+
+private:
+    Combat_engine() : resolved(false), applying_actions(false) {}
+    static Combat_engine* engine;
+
+    enum Resolution : char {UNDECIDED, IN_RANGE, OUT_OF_RANGE};
+
+    // the engagements, in no particular order
+    std::vector<int> attacker_slots;
+    std::vector<int> target_slots;
+    std::vector<double> ranges;
+    std::vector<char> targets_first;
+    std::vector<Resolution> resolutions;    // valid only while resolved is true
+    bool resolved;
+    // the engagement of each slot, or -1 if it has none
+    std::vector<int> slot_engagements;
+
+    // a hit to be received, or a retaliation to be started, by the subject
+    struct Combat_action {
+        bool is_hit;
+        std::shared_ptr<Ship> subject;
+        std::shared_ptr<Ship> other;
+        int hit_force;
+    };
+    std::deque<Combat_action> actions;
+    bool applying_actions;
+
+    // apply the queued actions in order, unless they are already being applied
+    void apply_actions();
+};
+
+#endif
@@ -0,0 +1,113 @@
+#include "Command_file.h"
+#include "Utility.h"
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+
+// longest number that is read, including the terminating null
+const int MAX_NUMBER_LENGTH = 64;
+
+// map the file into memory
+Command_file::Command_file(const string& filename) :
+    file(new Mapped_file(filename, "Could not open command file!")), end(file->get_end()), cursor(file->get_begin())
+{}
+// scan text that is already in memory
+Command_file::Command_file(const char* text_begin, const char* text_end) :
+    end(text_end), cursor(text_begin)
+{}
+
+// is there nothing left but whitespace?
+bool Command_file::at_end()
+{
+    skip_whitespace();
+    return cursor == end;
+}
+
+// is there nothing left on the current line but blanks?
+bool Command_file::at_line_end()
+{
+    while (cursor != end && *cursor != '\n' && isspace(static_cast<unsigned char>(*cursor))) ++cursor;
+    return cursor == end || *cursor == '\n';
+}
+
+// read the next whitespace-delimited word; return false if there is none
+bool Command_file::read_word(string& word)
+{
+    skip_whitespace();
+    if (cursor == end) return false;
+    const char* word_begin = cursor;
+    while (cursor != end && !isspace(static_cast<unsigned char>(*cursor))) ++cursor;
+    word.assign(word_begin, cursor);
+    return true;
+}
+
+// read a number; return false, consuming nothing, if none starts at the next word
+bool Command_file::read_int(int& value)
+{
+    skip_whitespace();
+    char buffer[MAX_NUMBER_LENGTH];
+    copy_number(buffer, MAX_NUMBER_LENGTH);
+    char* number_end;
+    errno = 0;
+    long result = strtol(buffer, &number_end, 10);
+    if (number_end == buffer || errno == ERANGE || result < INT_MIN || result > INT_MAX) return false;
+    cursor += number_end - buffer;
+    value = int(result);
+    return true;
+}
+bool Command_file::read_double(double& value)
+{
+    skip_whitespace();
+    char buffer[MAX_NUMBER_LENGTH];
+    copy_number(buffer, MAX_NUMBER_LENGTH);
+    char* number_end;
+    errno = 0;
+    double result = strtod(buffer, &number_end);
+    if (number_end == buffer || errno == ERANGE || !isfinite(result)) return false;
+    cursor += number_end - buffer;
+    value = result;
+    return true;
+}
+
+// discard the rest of the current line
+void Command_file::skip_line()
+{
+    while (cursor != end && *cursor != '\n') ++cursor;
+    if (cursor != end) ++cursor;
+}
+
+// advance the cursor over whitespace
+void Command_file::skip_whitespace()
+{
+    while (cursor != end && isspace(static_cast<unsigned char>(*cursor))) ++cursor;
+}
+
+// copy the characters that could form a number at the cursor into buffer, which holds
+// size characters including the terminating null. Only the characters that >> would
+// take are copied - a sign, digits, a decimal point, and an exponent with its sign -
+// so that words such as nan, inf, or hexadecimal numbers are not read as numbers.
+void Command_file::copy_number(char* buffer, int size) const
+{
+    int length = 0;
+    const char* next = cursor;
+    auto copy_if = [&](bool (*accept)(char)) {
+        if (next == end || length == size - 1 || !accept(*next)) return false;
+        buffer[length++] = *next++;
+        return true;
+    };
+    auto is_sign = [](char c) {return c == '+' || c == '-';};
+    auto is_digit = [](char c) {return isdigit(static_cast<unsigned char>(c)) != 0;};
+    copy_if(is_sign);
+    while (copy_if(is_digit)) {}
+    if (copy_if([](char c) {return c == '.';})) while (copy_if(is_digit)) {}
+    if (copy_if([](char c) {return c == 'e' || c == 'E';}))
+    {
+        copy_if(is_sign);
+        while (copy_if(is_digit)) {}
+    }
+    buffer[length] = '\0';
+}
@@ -0,0 +1,58 @@
+#ifndef COMMAND_FILE_H
+#define COMMAND_FILE_H
+
+#include "Mapped_file.h"
+#include <memory>
+#include <string>
+
+/* Command_file
+A Command_file gives the words and numbers of a file of commands in the same way
+that they are read from cin, for replaying large scripts quickly. The file is
+memory-mapped rather than read, and it is scanned in place: a word is located in
+the mapping and copied out only when it is returned, and a number is converted
+directly from the mapped characters. Like reading from cin with >>, reading skips
+leading whitespace, and a number is read from the longest prefix that forms one,
+leaving the rest of the word to be read next; words such as nan and inf, which >>
+does not accept, are not numbers here either. Text that is already in memory, such
+as a mapped scenario file or a built-in one, can be scanned in the same way.
+*/
+
+class Command_file {
+public:
+    // map the file into memory
+    // will throw Error("Could not open command file!") if the file cannot be read
+    Command_file(const std::string& filename);
+    // scan text that is already in memory, which must outlast this object
+    Command_file(const char* text_begin, const char* text_end);
+
+    // is there nothing left but whitespace?
+    bool at_end();
+    // is there nothing left on the current line but blanks?
+    bool at_line_end();
+
+    // read the next whitespace-delimited word; return false if there is none
+    bool read_word(std::string& word);
+    // read a number; return false, consuming nothing, if none starts at the next word
+    bool read_int(int& value);
+    bool read_double(double& value);
+
+    // discard the rest of the current line
+    void skip_line();
+
+    // disallow copy/move construction or assignment
+    Command_file(const Command_file&) = delete;
+    Command_file& operator=(const Command_file&) = delete;
+
+private:
+    std::unique_ptr<Mapped_file> file;  // null if the text was supplied
+    const char* end;
+    const char* cursor;
+
+    // advance the cursor over whitespace
+    void skip_whitespace();
+    // copy the characters that >> would take as part of a number at the cursor into
+    // buffer, which holds size characters including the terminating null
+    void copy_number(char* buffer, int size) const;
+};
+
+#endif
@@ -2,27 +2,40 @@
 #include "Model.h"
 #include "View.h"
 #include "Views.h"
+#include "Telemetry.h"
 #include "Ship.h"
 #include "Island.h"
 #include "Ship_factory.h"
+#include "Output.h"
+#include "Command_file.h"
+#include "Logistics.h"
+#include "Profiler.h"
 #include <algorithm>
+#include <cctype>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <cassert>
 
 using namespace std;
 using namespace placeholders;
 
 const char* const UNRECOGNIZED_ERROR_MSG = "Unrecognized command!";
 const int MAX_COURSE_DEGREES = 360;
+// the hours over which the tankers' routes are planned when they are not reassigned
+const int LOGISTICS_DEFAULT_HORIZON = 24;
 
 // output constructor message
-Controller::Controller() : view_map(views.end()), view_sail(views.end())
+Controller::Controller() : view_map(views.end()), view_sail(views.end()), command_file(nullptr),
+    error_count(0), logistics_period(0), logistics_time(0)
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Controller constructed" << endl;
+    init_output();
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Controller constructed" << '\n';
 }
 // output destructor message
 Controller::~Controller()
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Controller destructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Controller destructed" << '\n';
 }
 
 // create View object, run the program by accepting user commands, then destroy View object
@@ -33,62 +46,90 @@ void Controller::run()
         try
         {
             cout << "\nTime " << Model::get_Instance()->get_time() << ": Enter command: ";
-            string command;
-            cin >> command;
-            // first, check the command func map if this a command word
-            if (command_func_map.find(command) != command_func_map.end())
-            {
-                // if so, run function and return if it returns true
-                if ((this->*command_func_map[command])()) return;
-            }
-            else
-            {
-                // if not, find the ship with this name
-                shared_ptr<Ship> ship;
-                try { ship = Model::get_Instance()->get_ship_ptr(command); }
-                catch (Error& e) { throw Error(UNRECOGNIZED_ERROR_MSG); }
-                // if there is no ship with that name, an unrecognized command error will be thrown
-                // read in the ship command
-                string ship_command;
-                cin >> ship_command;
-                // check the ship func map if this is a command word
-                if (ship_func_map.find(ship_command) != ship_func_map.end())
-                {
-                    // if so, run the function
-                    (this->*ship_func_map[ship_command])(ship);
-                }
-                else
-                {
-                    // if not, throw an unrecognized command error
-                    throw Error(UNRECOGNIZED_ERROR_MSG);
-                }
-            }
+            flush_output();
+            if (run_command()) return;
         }
         catch (Error& e)
         {
-            cout << e.what() << endl;
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            ++error_count;
+            cout << e.what() << '\n';
+            skip_input_line();
         }
         catch (...)
         {
-            cout << "An unknown error occurred!" << endl;
+            cout << "An unknown error occurred!" << '\n';
             return;
         }
     }
 }
 
+// read and execute one command; return true if execution is to be ended
+bool Controller::run_command()
+{
+    string command = read_word();
+    // first, check the command func map if this a command word
+    if (command_func_map.find(command) != command_func_map.end())
+    {
+        // if so, run function and return its result
+        return (this->*command_func_map[command])();
+    }
+    // if not, find the ship with this name
+    shared_ptr<Ship> ship;
+    try { ship = Model::get_Instance()->get_ship_ptr(command); }
+    catch (Error& e) { throw Error(UNRECOGNIZED_ERROR_MSG); }
+    // if there is no ship with that name, an unrecognized command error will be thrown
+    // read in the ship command
+    string ship_command = read_word();
+    // check the ship func map if this is a command word
+    if (ship_func_map.find(ship_command) != ship_func_map.end())
+    {
+        // if so, run the function
+        (this->*ship_func_map[ship_command])(ship);
+    }
+    else
+    {
+        // if not, throw an unrecognized command error
+        throw Error(UNRECOGNIZED_ERROR_MSG);
+    }
+    return false;
+}
+
 // helper functions
+// is there nothing left on the current input line but blanks?
+bool Controller::at_end_of_line()
+{
+    if (command_file) return command_file->at_line_end();
+    while (cin.peek() != '\n' && isspace(cin.peek())) cin.get();
+    return cin.peek() == '\n' || cin.peek() == char_traits<char>::eof();
+}
+string Controller::read_word()
+{
+    string word;
+    if (!command_file) cin >> word;
+    else if (!command_file->read_word(word)) throw Error("Unexpected end of batch file!");
+    return word;
+}
+// discard the rest of the input line after an error
+void Controller::skip_input_line()
+{
+    if (command_file)
+    {
+        command_file->skip_line();
+        return;
+    }
+    cin.clear();
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+}
 int Controller::read_int()
 {
     int new_int;
-    if (!(cin >> new_int)) throw Error("Expected an integer!");
+    if (command_file ? !command_file->read_int(new_int) : !(cin >> new_int)) throw Error("Expected an integer!");
     return new_int;
 }
 double Controller::read_double()
 {
     double new_double;
-    if (!(cin >> new_double)) throw Error("Expected a double!");
+    if (command_file ? !command_file->read_double(new_double) : !(cin >> new_double)) throw Error("Expected a double!");
     return new_double;
 }
 double Controller::read_speed()
@@ -99,14 +140,12 @@ double Controller::read_speed()
 }
 shared_ptr<Ship> Controller::read_ship()
 {
-    string name;
-    cin >> name;
+    string name = read_word();
     return Model::get_Instance()->get_ship_ptr(name);
 }
 shared_ptr<Island> Controller::read_island()
 {
-    string name;
-    cin >> name;
+    string name = read_word();
     return Model::get_Instance()->get_island_ptr(name);
 }
 
@@ -115,14 +154,53 @@ bool Controller::quit()
 {
     Model *model = Model::get_Instance();
     for_each(views.begin(), views.end(), [model](weak_ptr<View> view){model->detach(view.lock());});
-    cout << "Done" << endl;
+    // the telemetry log is finished as the view is destroyed
+    if (telemetry_view) model->detach(telemetry_view);
+    telemetry_view.reset();
+    cout << "Done" << '\n';
     return true;
 }
+// run the commands of a file without prompting for them; an error skips the rest of
+// its line, as it does at the console. Running quit in the file ends the program.
+bool Controller::batch()
+{
+    if (command_file) throw Error("Cannot run a batch file from a batch file!");
+    Command_file file(read_word());
+    command_file = &file;
+    bool done = false;
+    try
+    {
+        while (!done && !file.at_end())
+        {
+            try
+            {
+                done = run_command();
+            }
+            catch (Error& e)
+            {
+                ++error_count;
+                cout << e.what() << '\n';
+                file.skip_line();
+            }
+            // without prompts, this is where the output of each command is flushed
+            flush_output();
+        }
+    }
+    catch (...)
+    {
+        command_file = nullptr;
+        throw;
+    }
+    command_file = nullptr;
+    return done;
+}
 
 // view functions
 bool Controller::view_show()
 {
-    for_each(views.begin(), views.end(), [](shared_ptr<View> view){view->draw();});
+    Model *model = Model::get_Instance();
+    // the output is flushed before each view is drawn, so that it is not lost if drawing fails
+    for_each(views.begin(), views.end(), [model](shared_ptr<View> view){model->refresh_view(view); flush_output(); view->draw();});
     return false;
 }
 bool Controller::view_map_open()
@@ -159,8 +237,7 @@ bool Controller::view_sail_close()
 }
 bool Controller::view_bridge_open()
 {
-    string name;
-    cin >> name;
+    string name = read_word();
     if (bridge_views.find(name) != bridge_views.end()) throw Error("Bridge view is already open for that ship!");
     Model *model = Model::get_Instance();
     shared_ptr<Ship> ship = model->get_ship_ptr(name); // make sure ship exists!
@@ -171,8 +248,7 @@ bool Controller::view_bridge_open()
 }
 bool Controller::view_bridge_close()
 {
-    string name;
-    cin >> name;
+    string name = read_word();
     auto bridge_it = bridge_views.find(name);
     if (bridge_it == bridge_views.end()) throw Error("Bridge view for that ship is not open!");
     ViewListIterator view_it = (*bridge_it).second;
@@ -181,6 +257,26 @@ bool Controller::view_bridge_close()
     bridge_views.erase(bridge_it);
     return false;
 }
+// start a telemetry log of the ships' state at the end of each tick
+bool Controller::view_telemetry_open()
+{
+    string filename = read_word();
+    if (telemetry_view) throw Error("Telemetry is already open!");
+    shared_ptr<View_telemetry> view_ptr = make_shared<View_telemetry>(filename);
+    Model::get_Instance()->attach(view_ptr);
+    telemetry_view = view_ptr;
+    return false;
+}
+// finish writing the telemetry log
+bool Controller::view_telemetry_close()
+{
+    if (!telemetry_view) throw Error("Telemetry is not open!");
+    shared_ptr<View_telemetry> view_ptr = telemetry_view;
+    telemetry_view.reset();
+    Model::get_Instance()->detach(view_ptr);
+    view_ptr->close();
+    return false;
+}
 
 // view_map functions
 bool Controller::view_map_default()
@@ -222,16 +318,35 @@ bool Controller::model_status()
 bool Controller::model_go()
 {
     Model::get_Instance()->update();
+    assign_tankers_if_due();
+    return false;
+}
+bool Controller::model_run()
+{
+    int hours = read_int();
+    if (hours < 0) throw Error("Number of hours must not be negative!");
+    run_until(Model::get_Instance()->get_time() + hours);
+    return false;
+}
+bool Controller::model_run_until()
+{
+    run_until(read_int());
+    return false;
+}
+bool Controller::model_quiet()
+{
+    string setting = read_word();
+    if (setting == "on") set_quiet_mode(true);
+    else if (setting == "off") set_quiet_mode(false);
+    else throw Error("Expected on or off!");
     return false;
 }
 bool Controller::model_create()
 {
-    string new_name;
-    cin >> new_name;
+    string new_name = read_word();
     if (new_name.size() < SHORTEN_NAME_LENGTH) throw Error("Name is too short!");
     if (Model::get_Instance()->is_name_in_use(new_name)) throw Error("Name is already in use!");
-    string new_type;
-    cin >> new_type;
+    string new_type = read_word();
     double point_x, point_y;
     point_x = read_double();
     point_y = read_double();
@@ -239,6 +354,101 @@ bool Controller::model_create()
     return false;
 }
 
+bool Controller::model_threads()
+{
+    Model::get_Instance()->set_thread_count(read_int());
+    return false;
+}
+// list the collision risks found at the last update; if a range and horizon are
+// supplied, they are set first, and the ships are screened again with them
+bool Controller::model_risks()
+{
+    Model* model = Model::get_Instance();
+    if (!at_end_of_line())
+    {
+        double range = read_double();
+        model->set_collision_risk_limits(range, read_double());
+    }
+    const vector<Collision_risk>& risks = model->get_collision_risks();
+    if (risks.empty()) cout << "No collision risks" << '\n';
+    for (auto&& risk : risks)
+    {
+        cout << Model::get_name_of_id(risk.ship_id) << " and " << Model::get_name_of_id(risk.other_id) <<
+                " closest approach " << risk.range << " nm in " << risk.time << " hr" << '\n';
+    }
+    return false;
+}
+bool Controller::model_save()
+{
+    Model::get_Instance()->save(read_word());
+    return false;
+}
+bool Controller::model_load()
+{
+    Model::get_Instance()->load(read_word());
+    return false;
+}
+bool Controller::model_scenario()
+{
+    Model::get_Instance()->load_scenario(read_word());
+    return false;
+}
+// reassign the tankers now, and then every supplied number of hours if it is not zero;
+// tankers that the plan has no use for are stopped, with their cargo destinations cleared
+bool Controller::model_logistics()
+{
+    int hours = read_int();
+    if (hours < 0) throw Error("Number of hours must not be negative!");
+    logistics_period = hours;
+    logistics_time = Model::get_Instance()->get_time();
+    assign_tanker_routes(hours ? hours : LOGISTICS_DEFAULT_HORIZON);
+    return false;
+}
+// output the profile of the recent ticks
+bool Controller::model_stats()
+{
+    print_profile_stats();
+    return false;
+}
+bool Controller::model_export_stats()
+{
+    export_profile_stats(read_word());
+    return false;
+}
+// output the occupancy of the pools the ships are allocated from
+bool Controller::model_pools()
+{
+    describe_ship_pools();
+    return false;
+}
+
+// advance the time to end_time, stopping to reassign the tankers when they are due
+void Controller::run_until(int end_time)
+{
+    Model* model = Model::get_Instance();
+    if (!logistics_period || end_time < model->get_time())
+    {
+        model->run_until(end_time);
+        return;
+    }
+    assign_tankers_if_due();
+    while (model->get_time() < end_time)
+    {
+        model->run_until(min(end_time, logistics_time + logistics_period));
+        assign_tankers_if_due();
+    }
+}
+// reassign the tankers if it is time to; the time may have gone back if a snapshot or
+// scenario was loaded, which makes them due at once
+void Controller::assign_tankers_if_due()
+{
+    if (!logistics_period) return;
+    int time = Model::get_Instance()->get_time();
+    if (time < logistics_time + logistics_period && time >= logistics_time) return;
+    logistics_time = time;
+    assign_tanker_routes(logistics_period);
+}
+
 // ship functions
 void Controller::ship_course(shared_ptr<Ship> ship)
 {
@@ -295,4 +505,22 @@ void Controller::ship_stop_attack(shared_ptr<Ship> ship)
 {
     assert(ship);
     ship->stop_attack();
+}
+// plan the routes of the ship's cruises in advance, or not
+void Controller::ship_plan_route(shared_ptr<Ship> ship)
+{
+    assert(ship);
+    string setting = read_word();
+    if (setting == "on") ship->set_route_planning(true);
+    else if (setting == "off") ship->set_route_planning(false);
+    else throw Error("Expected on or off!");
+}
+// have the warship attack the nearest ship in range at each update, or not
+void Controller::ship_auto_attack(shared_ptr<Ship> ship)
+{
+    assert(ship);
+    string setting = read_word();
+    if (setting == "on") ship->set_auto_attack(true);
+    else if (setting == "off") ship->set_auto_attack(false);
+    else throw Error("Expected on or off!");
 }
\ No newline at end of file
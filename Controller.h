@@ -12,8 +12,10 @@ class View;
 class View_map;
 class View_sail;
 class View_bridge;
+class View_telemetry;
 class Ship;
 class Island;
+class Command_file;
 
 /* Controller
 This class is responsible for controlling the Model and View according to interactions
@@ -29,6 +31,10 @@ public:
 	// create View object, run the program by accepting user commands, then destroy View object
 	void run();
 
+	// return the number of commands that have failed with an error message
+	int get_error_count() const
+		{return error_count;}
+
 private:
 	typedef std::list<std::shared_ptr<View>> ViewList;
 	typedef ViewList::iterator ViewListIterator;
@@ -37,8 +43,30 @@ private:
 	ViewListIterator view_map;
 	ViewListIterator view_sail;
 	std::map<std::string, ViewListIterator> bridge_views;
-
-	// helper functions
+	// the telemetry log being written, which is not drawn with the other views
+	std::shared_ptr<View_telemetry> telemetry_view;
+
+	// the batch file being run, whose commands are read instead of those from cin
+	Command_file* command_file;
+	int error_count;
+
+	// the hours between reassignments of the tankers, or zero if they are not reassigned,
+	// and the time of the last reassignment
+	int logistics_period;
+	int logistics_time;
+
+	// advance the time to end_time, stopping to reassign the tankers when they are due
+	void run_until(int end_time);
+	// reassign the tankers if it is time to
+	void assign_tankers_if_due();
+
+	// read and execute one command; return true if execution is to be ended
+	bool run_command();
+
+	// helper functions - these read from the batch file if one is being run
+	bool at_end_of_line();
+	std::string read_word();
+	void skip_input_line();
 	int read_int();
 	double read_double();
 	double read_speed();
@@ -49,6 +77,7 @@ private:
 	typedef bool (Controller::*command_func)();
 	// these functions return true if execution is to be ended, false otherwise
 	bool quit();
+	bool batch();
 
 	// view functions
 	bool view_show();
@@ -58,6 +87,8 @@ private:
 	bool view_sail_close();
 	bool view_bridge_open();
 	bool view_bridge_close();
+	bool view_telemetry_open();
+	bool view_telemetry_close();
 
 	// view_map functions
 	bool view_map_default();
@@ -68,7 +99,19 @@ private:
 	// model functions
 	bool model_status();
 	bool model_go();
+	bool model_run();
+	bool model_run_until();
+	bool model_quiet();
 	bool model_create();
+	bool model_threads();
+	bool model_risks();
+	bool model_save();
+	bool model_load();
+	bool model_scenario();
+	bool model_logistics();
+	bool model_stats();
+	bool model_export_stats();
+	bool model_pools();
 
 	// ship functions
 	typedef void (Controller::*ship_func)(std::shared_ptr<Ship>);
@@ -82,9 +125,12 @@ private:
 	void ship_refuel(std::shared_ptr<Ship> ship);
 	void ship_stop(std::shared_ptr<Ship> ship);
 	void ship_stop_attack(std::shared_ptr<Ship> ship);
+	void ship_plan_route(std::shared_ptr<Ship> ship);
+	void ship_auto_attack(std::shared_ptr<Ship> ship);
 
 	std::map<std::string, command_func> command_func_map {
 			{"quit", &Controller::quit},
+			{"batch", &Controller::batch},
 
 			{"show", &Controller::view_show},
 			{"open_map_view", &Controller::view_map_open},
@@ -93,6 +139,8 @@ private:
 			{"close_sailing_view", &Controller::view_sail_close},
 			{"open_bridge_view", &Controller::view_bridge_open},
 			{"close_bridge_view", &Controller::view_bridge_close},
+			{"open_telemetry", &Controller::view_telemetry_open},
+			{"close_telemetry", &Controller::view_telemetry_close},
 
 			{"default", &Controller::view_map_default},
 			{"size", &Controller::view_map_size},
@@ -101,7 +149,19 @@ private:
 
 			{"status", &Controller::model_status},
 			{"go", &Controller::model_go},
-			{"create", &Controller::model_create}
+			{"run", &Controller::model_run},
+			{"run_until", &Controller::model_run_until},
+			{"quiet", &Controller::model_quiet},
+			{"create", &Controller::model_create},
+			{"threads", &Controller::model_threads},
+			{"risks", &Controller::model_risks},
+			{"save", &Controller::model_save},
+			{"load", &Controller::model_load},
+			{"scenario", &Controller::model_scenario},
+			{"logistics", &Controller::model_logistics},
+			{"stats", &Controller::model_stats},
+			{"export_stats", &Controller::model_export_stats},
+			{"pools", &Controller::model_pools}
 	};
 
 	std::map<std::string, ship_func> ship_func_map {
@@ -114,7 +174,9 @@ private:
 			{"attack", &Controller::ship_attack},
 			{"refuel", &Controller::ship_refuel},
 			{"stop", &Controller::ship_stop},
-			{"stop_attack", &Controller::ship_stop_attack}
+			{"stop_attack", &Controller::ship_stop_attack},
+			{"plan_route", &Controller::ship_plan_route},
+			{"auto_attack", &Controller::ship_auto_attack}
 	};
 };
 
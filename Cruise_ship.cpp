@@ -1,5 +1,8 @@
 #include "Cruise_ship.h"
 #include "Island.h"
+#include "Snapshot.h"
+#include "Profiler.h"
+#include "Tour_planner.h"
 #include <cassert>
 #include <algorithm>
 #include <iostream>
@@ -14,24 +17,20 @@ const double CRUISE_SHIP_INIT_RESISTANCE = 0;
 Cruise_ship::Cruise_ship(const std::string &name_, Point position_) :
         Ship(name_, position_, CRUISE_SHIP_INIT_FUEL, CRUISE_SHIP_MAX_SPEED,
                 CRUISE_SHIP_FUEL_CONSUMPTION, CRUISE_SHIP_INIT_RESISTANCE),
-        cruise_speed(0), cruise_state(State_cruise_ship::OFF_CRUISE)
+        cruise_speed(0), cruise_state(State_cruise_ship::OFF_CRUISE),
+        route_planning(false), route_planned(false)
 {
-    Model::Island_map island_map = Model::get_Instance()->get_islands();
-    for (auto&& island_pair : island_map)
-    {
-        all_islands[island_pair.second->get_location()] = island_pair.second;
-        all_islands_in_order.push_back(island_pair.second);
-    }
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Cruise ship " << get_name() << " constructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Cruise ship " << get_name() << " constructed" << '\n';
 }
 
 Cruise_ship::~Cruise_ship()
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Cruise ship " << get_name() << " destructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Cruise ship " << get_name() << " destructed" << '\n';
 }
 
 void Cruise_ship::update()
 {
+    PROFILE_SCOPE(PROFILE_CRUISE_SHIP_UPDATE);
     Ship::update();
 
     switch (cruise_state)
@@ -43,7 +42,7 @@ void Cruise_ship::update()
             dock(target_island);
             if (target_island == first_island && islands_left.empty())
             {
-                cout << get_name() << " cruise is over at " << first_island->get_name() << endl;
+                cout << get_name() << " cruise is over at " << first_island->get_name() << '\n';
                 end_cruise();
                 return;
             }
@@ -52,7 +51,13 @@ void Cruise_ship::update()
         case State_cruise_ship::REFUELING:
             refuel();
             cruise_state = State_cruise_ship::SIGHTSEEING;
-            // scope for declaring variables
+            if (route_planned)
+            {
+                // the island being visited is the last of the islands left
+                assert(!islands_left.empty() && islands_left.back() == target_island);
+                islands_left.pop_back();
+            }
+            else
             {
                 auto island_it = lower_bound(islands_left.begin(), islands_left.end(),
                         target_island, island_name_compare);
@@ -66,29 +71,40 @@ void Cruise_ship::update()
             cruise_state = State_cruise_ship::READY_TO_DEPART;
             return;
         case State_cruise_ship::READY_TO_DEPART:
-            // scope for declaring variables
+            // a planned cruise goes to the next island on its route
+            if (route_planned) target_island = islands_left.empty() ? first_island : islands_left.back();
+            // otherwise go to the nearest island left, using the Model's spatial index;
+            // if there is a tie the first alphabetical island will be chosen
+            else
             {
-                double min_dist = -1;
-                target_island = first_island;
-                for (auto &&island : islands_left) {
-                    double dist = cartesian_distance(get_location(), island->get_location());
-                    // note: because we are iterating through islands_left in order,
-                    // if there is a tie the first alphabetical island will be chosen
-                    if (min_dist == -1 || dist < min_dist) {
-                        min_dist = dist;
-                        target_island = island;
-                    }
-                }
+                target_island = Model::get_Instance()->find_nearest_island(get_location(),
+                        [this](const string& name){return is_island_left(name);});
+                if (!target_island) target_island = first_island;
             }
             // crash if for some reason the function call fails
             try {Ship::set_destination_position_and_speed(target_island->get_location(), cruise_speed);}
             catch (...) {assert(false);}
-            cout << get_name() << " will visit " << target_island->get_name() << endl;
+            cout << get_name() << " will visit " << target_island->get_name() << '\n';
             cruise_state = State_cruise_ship::TRAVELING_TO_ISLAND;
             return;
     }
 }
 
+// a Cruise_ship has an event every hour while at an island during a cruise,
+// and when it stops at an island
+int Cruise_ship::get_next_event_delay() const
+{
+    switch (cruise_state)
+    {
+        case State_cruise_ship::OFF_CRUISE:
+            return Ship::get_next_event_delay();
+        case State_cruise_ship::TRAVELING_TO_ISLAND:
+            return is_moving() ? Ship::get_next_event_delay() : 1;
+        default:
+            return 1;
+    }
+}
+
 void Cruise_ship::describe() const
 {
     cout << "\nCruise_ship ";
@@ -98,10 +114,10 @@ void Cruise_ship::describe() const
         case State_cruise_ship::OFF_CRUISE:
             return;
         case State_cruise_ship::TRAVELING_TO_ISLAND:
-            cout << "On cruise to " << target_island->get_name() << endl;
+            cout << "On cruise to " << target_island->get_name() << '\n';
             return;
         default:
-            cout << "Waiting during cruise at " << get_docked_Island()->get_name() << endl;
+            cout << "Waiting during cruise at " << get_docked_Island()->get_name() << '\n';
             return;
     }
 }
@@ -111,9 +127,9 @@ void Cruise_ship::set_destination_position_and_speed(Point destination_position,
 {
     check_and_cancel_cruise();
     Ship::set_destination_position_and_speed(destination_position, speed);
-    auto island_it = all_islands.find(destination_position);
-    if (island_it == all_islands.end()) return;
-    begin_cruise(speed, (*island_it).second);
+    shared_ptr<Island> island = get_all_islands().find_at(destination_position);
+    if (!island) return;
+    begin_cruise(speed, island);
 }
 
 // end cruise if necessary
@@ -128,18 +144,87 @@ void Cruise_ship::stop()
     Ship::stop();
 }
 
+// plan the whole route of each cruise when it begins, instead of going to the
+// nearest island left after each visit
+void Cruise_ship::set_route_planning(bool planned)
+{
+    route_planning = planned;
+}
+
+void Cruise_ship::save_state(Snapshot_writer& writer) const
+{
+    Ship::save_state(writer);
+    writer.write_double(cruise_speed);
+    writer.write_int(static_cast<int>(cruise_state));
+    writer.write_int(route_planning);
+    writer.write_int(route_planned);
+    writer.write_string(first_island ? first_island->get_name() : "");
+    writer.write_string(target_island ? target_island->get_name() : "");
+    writer.write_int(int(islands_left.size()));
+    for (auto&& island : islands_left) writer.write_string(island->get_name());
+}
+void Cruise_ship::restore_state(Snapshot_reader& reader)
+{
+    Ship::restore_state(reader);
+    Model* model = Model::get_Instance();
+    cruise_speed = reader.read_double();
+    cruise_state = static_cast<State_cruise_ship>(reader.read_enum(int(State_cruise_ship::READY_TO_DEPART) + 1));
+    route_planning = reader.read_int() != 0;
+    route_planned = reader.read_int() != 0;
+    string first_island_name = reader.read_string();
+    first_island = first_island_name.empty() ? nullptr : model->get_island_ptr(first_island_name);
+    string target_island_name = reader.read_string();
+    target_island = target_island_name.empty() ? nullptr : model->get_island_ptr(target_island_name);
+    islands_left.clear();
+    int islands_left_count = reader.read_int();
+    for (int i = 0; i < islands_left_count; i++) islands_left.push_back(model->get_island_ptr(reader.read_string()));
+}
+
+// return true if the named island has not been visited yet on this cruise
+bool Cruise_ship::is_island_left(const string& name) const
+{
+    auto island_it = lower_bound(islands_left.begin(), islands_left.end(), name,
+            [](shared_ptr<Island> island, const string& name){return island->get_name() < name;});
+    return island_it != islands_left.end() && (*island_it)->get_name() == name;
+}
+
+// set islands_left to the islands in reverse order of a short route starting at the first island,
+// so that the next island to visit is always the last one
+void Cruise_ship::plan_route()
+{
+    const vector<shared_ptr<Island>>& islands_in_order = get_all_islands().get_islands_in_order();
+    vector<Point> locations;
+    locations.reserve(islands_in_order.size());
+    for (auto&& island : islands_in_order) locations.push_back(island->get_location());
+    auto first_it = lower_bound(islands_in_order.begin(), islands_in_order.end(), first_island, island_name_compare);
+    assert(first_it != islands_in_order.end() && *first_it == first_island);
+    vector<int> route = plan_tour(locations, int(first_it - islands_in_order.begin()));
+    islands_left.clear();
+    islands_left.reserve(route.size());
+    for (auto route_it = route.rbegin(); route_it != route.rend(); ++route_it) islands_left.push_back(islands_in_order[*route_it]);
+}
+
+// return the registry of all of the islands, getting the Model's current one if they have changed
+const Island_registry& Cruise_ship::get_all_islands()
+{
+    Model* model = Model::get_Instance();
+    if (!islands || islands->get_version() != model->get_island_version()) islands = model->get_island_registry();
+    return *islands;
+}
+
 void Cruise_ship::begin_cruise(double speed, shared_ptr<Island> island)
 {
     assert(cruise_state == State_cruise_ship::OFF_CRUISE);
-    islands_left.clear();
-    islands_left.insert(islands_left.begin(), all_islands_in_order.begin(), all_islands_in_order.end());
-    // islands_left will be in order by name because all_islands is in order by name
     first_island = island;
     target_island = island;
+    route_planned = route_planning;
+    if (route_planned) plan_route();
+    // islands_left will be in order by name because the registry's islands are in order by name
+    else islands_left = get_all_islands().get_islands_in_order();
     cruise_state = State_cruise_ship::TRAVELING_TO_ISLAND;
     cruise_speed = speed;
-    cout << get_name() << " will visit " << island->get_name() << endl;
-    cout << get_name() << " cruise will start and end at " << island->get_name() << endl;
+    cout << get_name() << " will visit " << island->get_name() << '\n';
+    cout << get_name() << " cruise will start and end at " << island->get_name() << '\n';
 }
 void Cruise_ship::end_cruise()
 {
@@ -148,6 +233,7 @@ void Cruise_ship::end_cruise()
     first_island.reset();
     target_island.reset();
     cruise_state = State_cruise_ship::OFF_CRUISE;
+    route_planned = false;
     cruise_speed = 0;
 }
 void Cruise_ship::check_and_cancel_cruise()
@@ -155,6 +241,6 @@ void Cruise_ship::check_and_cancel_cruise()
     if (cruise_state != State_cruise_ship::OFF_CRUISE)
     {
         end_cruise();
-        cout << get_name() << " canceling current cruise" << endl;
+        cout << get_name() << " canceling current cruise" << '\n';
     }
 }
\ No newline at end of file
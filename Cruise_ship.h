@@ -4,6 +4,7 @@
 #include "Ship.h"
 #include "Island.h"
 #include "Geometry.h"
+#include "Island_registry.h"
 #include <string>
 #include <map>
 #include <memory>
@@ -20,6 +21,10 @@ public:
 
     void describe() const override;
 
+    // a Cruise_ship has an event every hour while at an island during a cruise,
+    // and when it stops at an island
+    int get_next_event_delay() const override;
+
     // checks if destination is an island, and if so, begins a cruise, or stops its cruise if the destination is not
     void set_destination_position_and_speed(Point destination_position, double speed) override;
 
@@ -27,20 +32,37 @@ public:
     void set_course_and_speed(double course, double speed) override;
     void stop() override;
 
+    // plan the whole route of each cruise when it begins, instead of going to the
+    // nearest island left after each visit
+    void set_route_planning(bool planned) override;
+
+    std::string get_type_name() const override
+        {return "Cruise_ship";}
+
+    void save_state(Snapshot_writer& writer) const override;
+    void restore_state(Snapshot_reader& reader) override;
+
 private:
-    std::map<Point, std::shared_ptr<Island>> all_islands;        // all of the islands in the simulation
-    std::vector<std::shared_ptr<Island>> all_islands_in_order;  // all of the islands in this simulation ordered by name
-    std::vector<std::shared_ptr<Island>> islands_left;           // islands left in this cruise
+    std::shared_ptr<const Island_registry> islands;             // all of the islands, shared with the Model
+    std::vector<std::shared_ptr<Island>> islands_left;           // islands left in this cruise, in order by name,
+                                                                 // or in reverse order of the route if it is planned
 
     std::shared_ptr<Island> first_island;   // the first island visited, to be returned to at the end of the cruise
     std::shared_ptr<Island> target_island;  // the island the ship is currently heading to
 
     double cruise_speed;
     State_cruise_ship  cruise_state;
+    bool route_planning;    // whether cruises are planned when they begin
+    bool route_planned;     // whether the current cruise was planned
 
     void begin_cruise(double speed, std::shared_ptr<Island> island);
     void end_cruise();
     void check_and_cancel_cruise();
+    bool is_island_left(const std::string& name) const;
+    // set islands_left to the islands in reverse order of a short route starting at the first island
+    void plan_route();
+    // return the registry of all of the islands, getting the Model's current one if they have changed
+    const Island_registry& get_all_islands();
 
     static bool island_name_compare(std::shared_ptr<Island> first, std::shared_ptr<Island> second)
     {
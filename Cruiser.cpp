@@ -1,4 +1,6 @@
 #include "Cruiser.h"
+#include "Combat_engine.h"
+#include "Profiler.h"
 #include <iostream>
 
 using namespace std;
@@ -15,17 +17,18 @@ Cruiser::Cruiser(const string &name_, Point position_) :
         Warship(name_, position_, CRUISER_INIT_FUEL, CRUISER_MAX_SPEED, CRUISER_FUEL_CONSUMPTION,
                 CRUISER_INIT_RESISTANCE, CRUISER_FIREPOWER, CRUISER_MAX_RANGE)
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Cruiser " << get_name() << " constructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Cruiser " << get_name() << " constructed" << '\n';
 }
 
 // output destructor message
 Cruiser::~Cruiser()
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Cruiser " << get_name() << " destructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Cruiser " << get_name() << " destructed" << '\n';
 }
 
 void Cruiser::update()
 {
+    PROFILE_SCOPE(PROFILE_CRUISER_UPDATE);
     Warship::update();
     if (!is_attacking()) return;
     if (target_in_range())
@@ -34,7 +37,7 @@ void Cruiser::update()
     }
     else
     {
-        cout << get_name() << " target is out of range" << endl;
+        cout << get_name() << " target is out of range" << '\n';
         stop_attack();
     }
 }
@@ -48,5 +51,7 @@ void Cruiser::describe() const
 void Cruiser::receive_hit(int hit_force, shared_ptr<Ship> attacker_ptr)
 {
     Ship::receive_hit(hit_force, attacker_ptr);
-    if (is_afloat() && !is_attacking()) attack(attacker_ptr);
+    // the attack starts once the hit has been dealt with, not from within it
+    if (is_afloat() && !is_attacking())
+        Combat_engine::get_Instance()->retaliate(dynamic_pointer_cast<Ship, Sim_object>(shared_from_this()), attacker_ptr);
 }
\ No newline at end of file
@@ -33,6 +33,9 @@ public:
 
 	void receive_hit(int hit_force, std::shared_ptr<Ship> attacker_ptr) override;
 
+	std::string get_type_name() const override
+		{return "Cruiser";}
+
 };
 
 #endif
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Island.h"
+#include "Snapshot.h"
 #include "Model.h"
+#include "Profiler.h"
 #include <iostream>
 
 using namespace std;
@@ -8,48 +10,69 @@ using namespace std;
 Island::Island(const string &name_, Point position_, double fuel_, double production_rate_) :
         Sim_object(name_), position(position_), fuel(fuel_), production_rate(production_rate_)
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Island " << get_name() << " constructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Island " << get_name() << " constructed" << '\n';
 }
 
 // output destructor message
 Island::~Island()
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Island " << get_name() << " destructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Island " << get_name() << " destructed" << '\n';
 }
 
 // Return whichever is less, the request or the amount left,
 // update the amount on hand accordingly, and output the amount supplied.
 double Island::provide_fuel(double request)
 {
+    Model::get_Instance()->bring_up_to_date(*this);
     double min = request < fuel ? request : fuel;
     fuel -= min;
-    cout << "Island " << get_name() << " supplied " << min << " tons of fuel" << endl;
+    cout << "Island " << get_name() << " supplied " << min << " tons of fuel" << '\n';
     return min;
 }
 
 // Add the amount to the amount on hand, and output the total as the amount the Island now has.
 void Island::accept_fuel(double amount)
 {
+    Model::get_Instance()->bring_up_to_date(*this);
     fuel += amount;
-    cout << "Island " << get_name() << " now has " << fuel << " tons" << endl;
+    cout << "Island " << get_name() << " now has " << fuel << " tons" << '\n';
 }
 
 // if production_rate > 0, compute production_rate * unit time, and add to amount, and print an update message
 void Island::update()
 {
+    PROFILE_SCOPE(PROFILE_ISLAND_UPDATE);
     if (production_rate <= 0) return;
     fuel += production_rate;
-    cout << "Island " << get_name() << " now has " << fuel << " tons" << endl;
+    cout << "Island " << get_name() << " now has " << fuel << " tons" << '\n';
+}
+
+// add the production of the supplied number of hours
+void Island::advance_quietly(int hours)
+{
+    if (production_rate <= 0) return;
+    fuel += production_rate * hours;
 }
 
 // output information about the current state
 void Island::describe() const
 {
-    cout << "\nIsland " << get_name() << " at position " << position << "\nFuel available: " << fuel << " tons" << endl;
+    cout << "\nIsland " << get_name() << " at position " << position << "\nFuel available: " << fuel << " tons" << '\n';
 }
 
 // ask model to notify views of current state
 void Island::broadcast_current_state()
 {
-    Model::get_Instance()->notify_location_island(get_name(), position);
-}
\ No newline at end of file
+    Model::get_Instance()->notify_location_island(get_id(), position);
+}
+
+void Island::save_state(Snapshot_writer& writer) const
+{
+    writer.write_double(fuel);
+    writer.write_double(production_rate);
+}
+void Island::restore_state(Snapshot_reader& reader)
+{
+    fuel = reader.read_double();
+    production_rate = reader.read_double();
+}
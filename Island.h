@@ -2,6 +2,7 @@
 #define ISLAND_H
 #include "Sim_object.h"
 #include "Geometry.h"
+#include "Utility.h"
 #include <string>
 
 /***** Island Class *****/
@@ -29,15 +30,29 @@ public:
         return position;
     }
 
+    double get_fuel() const
+        {return fuel;}
+    double get_production_rate() const
+        {return production_rate;}
+
     // if production_rate > 0, compute production_rate * unit time, and add to amount, and print an update message
     void update() override;
 
+    // production is steady progress, so an Island has no events
+    int get_next_event_delay() const override
+        {return NO_EVENT_DELAY;}
+    // add the production of the supplied number of hours
+    void advance_quietly(int hours) override;
+
     // output information about the current state
     void describe() const override;
 
     // ask model to notify views of current state
     void broadcast_current_state() override;
 
+    void save_state(Snapshot_writer& writer) const override;
+    void restore_state(Snapshot_reader& reader) override;
+
     // forbid  copy/move, construction/assignment
     Island(const Island&) = delete;
     Island& operator=(const Island&) = delete;
@@ -0,0 +1,27 @@
+#include "Island_registry.h"
+#include "Island.h"
+#include <algorithm>
+
+using namespace std;
+
+Island_registry::Island_registry(vector<shared_ptr<Island>> islands_in_order_, int version_) :
+    islands_in_order(move(islands_in_order_)), version(version_)
+{
+    islands_by_location.reserve(islands_in_order.size());
+    for (int i = 0; i < int(islands_in_order.size()); i++)
+    {
+        islands_by_location.push_back(make_pair(islands_in_order[i]->get_location(), i));
+    }
+    // islands at the same location stay in name order
+    stable_sort(islands_by_location.begin(), islands_by_location.end(),
+            [](const pair<Point, int>& first, const pair<Point, int>& second){return first.first < second.first;});
+}
+
+// return the island at the location, or an empty pointer if there is none
+shared_ptr<Island> Island_registry::find_at(Point location) const
+{
+    auto location_it = upper_bound(islands_by_location.begin(), islands_by_location.end(), location,
+            [](Point location, const pair<Point, int>& entry){return location < entry.first;});
+    if (location_it == islands_by_location.begin() || (location_it - 1)->first != location) return nullptr;
+    return islands_in_order[(location_it - 1)->second];
+}
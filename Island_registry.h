@@ -0,0 +1,42 @@
+#ifndef ISLAND_REGISTRY_H
+#define ISLAND_REGISTRY_H
+
+#include "Geometry.h"
+#include <memory>
+#include <utility>
+#include <vector>
+
+class Island;
+
+/* Island_registry
+An Island_registry is a read-only record of all of the islands at one time, for the
+objects that need to go through the islands in name order or find the island at a
+location. The Model makes one, shares it with every object that asks for it, and makes
+a new one with a higher version number when the islands change, so that an object can
+tell that the registry it holds is out of date by comparing version numbers.
+*/
+
+class Island_registry {
+public:
+    // the islands must be in order by name
+    Island_registry(std::vector<std::shared_ptr<Island>> islands_in_order_, int version_);
+
+    int get_version() const
+        {return version;}
+    const std::vector<std::shared_ptr<Island>>& get_islands_in_order() const
+        {return islands_in_order;}
+    // return the island at the location, or an empty pointer if there is none;
+    // of islands at the same location, the last by name is returned
+    std::shared_ptr<Island> find_at(Point location) const;
+
+    // disallow copy/move construction or assignment
+    Island_registry(const Island_registry&) = delete;
+    Island_registry& operator=(const Island_registry&) = delete;
+
+private:
+    std::vector<std::shared_ptr<Island>> islands_in_order;
+    std::vector<std::pair<Point, int>> islands_by_location;    // locations with the indexes of their islands
+    int version;
+};
+
+#endif
@@ -0,0 +1,248 @@
+#include "Logistics.h"
+#include "Model.h"
+#include "Tanker.h"
+#include "Island.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <memory>
+
+using namespace std;
+
+// the hours a tanker spends in each round trip docking, loading and unloading
+const double LOGISTICS_HANDLING_HOURS = 4.;
+
+/* Fleet_plan
+A Fleet_plan holds the state of the transport problem while tankers are added to it.
+Each route is a node, and so is being idle; a tanker is always at one node. Moving a
+tanker between two nodes changes the cost by the difference of its costs at them, so
+for each pair of nodes a heap holds the tankers at the first, cheapest move first.
+*/
+class Fleet_plan {
+public:
+    Fleet_plan(const vector<Point>& tanker_locations_, const vector<Point>& route_locations_,
+            const vector<double>& route_rates_, const vector<double>& route_supplies_,
+            double tanker_speed_, double horizon_);
+
+    // add the tanker to the plan, reassigning the others as needed to keep the plan optimal
+    void add_tanker(int tanker);
+
+    // return the node of the tanker; the idle node is the number of routes
+    int get_node(int tanker) const
+        {return tanker_nodes[tanker];}
+
+private:
+    const vector<Point>& tanker_locations;
+    const vector<Point>& route_locations;
+    const vector<double>& route_rates;      // tons per hour delivered by one tanker
+    const vector<double>& route_supplies;   // tons that can be loaded over the horizon
+    double tanker_speed;
+    double horizon;
+    int idle_node;
+    int node_count;
+
+    vector<int> tanker_nodes;       // -1 for a tanker not yet added
+    vector<int> node_tanker_counts;
+    vector<double> potentials;      // keep the costs of moves non-negative for Dijkstra
+    typedef pair<double, int> Move; // the change in cost and the tanker to move
+    vector<vector<Move>> moves;     // a min-heap for each pair of nodes
+
+    // the tons lost by the tanker sailing to the node instead of delivering
+    double cost(int tanker, int node) const;
+    // the cost of one more tanker at the node, the negative of the tons it adds
+    double next_tanker_cost(int node) const;
+    // return the cheapest move of a tanker from one node to another, or nullptr if there is none
+    const Move* cheapest_move(int from, int to);
+    void move_tanker(int tanker, int node);
+};
+
+Fleet_plan::Fleet_plan(const vector<Point>& tanker_locations_, const vector<Point>& route_locations_,
+        const vector<double>& route_rates_, const vector<double>& route_supplies_,
+        double tanker_speed_, double horizon_) :
+    tanker_locations(tanker_locations_), route_locations(route_locations_),
+    route_rates(route_rates_), route_supplies(route_supplies_),
+    tanker_speed(tanker_speed_), horizon(horizon_),
+    idle_node(int(route_locations_.size())), node_count(idle_node + 1),
+    tanker_nodes(tanker_locations_.size(), -1), node_tanker_counts(node_count, 0),
+    potentials(node_count, 0.), moves(node_count * node_count)
+{
+}
+
+// the tons lost by the tanker sailing to the node instead of delivering
+double Fleet_plan::cost(int tanker, int node) const
+{
+    if (node == idle_node) return 0.;
+    double hours = cartesian_distance(tanker_locations[tanker], route_locations[node]) / tanker_speed;
+    return route_rates[node] * min(hours, horizon);
+}
+
+// the cost of one more tanker at the node, the negative of the tons it adds
+double Fleet_plan::next_tanker_cost(int node) const
+{
+    if (node == idle_node) return 0.;
+    double tanker_tons = route_rates[node] * horizon;
+    double supply_left = route_supplies[node] - node_tanker_counts[node] * tanker_tons;
+    return -max(0., min(tanker_tons, supply_left));
+}
+
+// return the cheapest move of a tanker from one node to another, discarding moves of
+// tankers that have since left the first node
+const Fleet_plan::Move* Fleet_plan::cheapest_move(int from, int to)
+{
+    vector<Move>& heap = moves[from * node_count + to];
+    while (!heap.empty() && tanker_nodes[heap.front().second] != from)
+    {
+        pop_heap(heap.begin(), heap.end(), greater<Move>());
+        heap.pop_back();
+    }
+    return heap.empty() ? nullptr : &heap.front();
+}
+
+void Fleet_plan::move_tanker(int tanker, int node)
+{
+    if (tanker_nodes[tanker] >= 0) --node_tanker_counts[tanker_nodes[tanker]];
+    tanker_nodes[tanker] = node;
+    ++node_tanker_counts[node];
+    double node_cost = cost(tanker, node);
+    for (int other = 0; other < node_count; other++)
+    {
+        if (other == node) continue;
+        vector<Move>& heap = moves[node * node_count + other];
+        heap.push_back(Move(cost(tanker, other) - node_cost, tanker));
+        push_heap(heap.begin(), heap.end(), greater<Move>());
+    }
+}
+
+// find the cheapest way to add the tanker: go to some node, possibly moving a tanker from
+// there to another node, and so on, ending where one more tanker costs the least.
+// Dijkstra's algorithm runs on costs reduced by the potentials, which are the costs of
+// the last tanker's paths, so that no move costs less than zero.
+void Fleet_plan::add_tanker(int tanker)
+{
+    vector<double> reduced_costs(node_count);
+    vector<int> previous_nodes(node_count, -1);    // -1 for the tanker being added
+    vector<int> moved_tankers(node_count, -1);
+    vector<bool> done(node_count, false);
+    for (int node = 0; node < node_count; node++) reduced_costs[node] = cost(tanker, node) - potentials[node];
+    for (int i = 0; i < node_count; i++)
+    {
+        int nearest = -1;
+        for (int node = 0; node < node_count; node++)
+        {
+            if (!done[node] && (nearest < 0 || reduced_costs[node] < reduced_costs[nearest])) nearest = node;
+        }
+        done[nearest] = true;
+        for (int node = 0; node < node_count; node++)
+        {
+            if (done[node]) continue;
+            const Move* move = cheapest_move(nearest, node);
+            if (!move) continue;
+            double node_cost = reduced_costs[nearest] + move->first + potentials[nearest] - potentials[node];
+            if (node_cost < reduced_costs[node])
+            {
+                reduced_costs[node] = node_cost;
+                previous_nodes[node] = nearest;
+                moved_tankers[node] = move->second;
+            }
+        }
+    }
+    int end_node = idle_node;
+    double end_cost = numeric_limits<double>::max();
+    for (int node = 0; node < node_count; node++)
+    {
+        potentials[node] += reduced_costs[node];
+        double node_cost = potentials[node] + next_tanker_cost(node);
+        if (node_cost < end_cost)
+        {
+            end_node = node;
+            end_cost = node_cost;
+        }
+    }
+    // make the moves along the path, from its end back to the tanker being added
+    int node = end_node;
+    while (previous_nodes[node] >= 0)
+    {
+        move_tanker(moved_tankers[node], node);
+        node = previous_nodes[node];
+    }
+    move_tanker(tanker, node);
+}
+
+// return the route of each tanker, for tankers at the supplied locations that are all alike
+vector<Logistics_route> plan_tanker_routes(const vector<Point>& tanker_locations,
+        const vector<Logistics_island>& islands, double tanker_speed, double tanker_capacity, double horizon)
+{
+    assert(tanker_speed > 0. && horizon > 0.);
+    vector<Logistics_route> routes(tanker_locations.size());
+    // a route loads at each island that produces fuel and unloads at the nearest that does not
+    vector<int> load_islands, unload_islands;
+    vector<Point> route_locations;
+    vector<double> route_rates, route_supplies;
+    for (int i = 0; i < int(islands.size()); i++)
+    {
+        if (islands[i].production_rate <= 0.) continue;
+        int unload_island = -1;
+        double unload_distance = 0.;
+        for (int j = 0; j < int(islands.size()); j++)
+        {
+            if (islands[j].production_rate > 0.) continue;
+            double distance = cartesian_distance(islands[i].location, islands[j].location);
+            if (unload_island < 0 || distance < unload_distance)
+            {
+                unload_island = j;
+                unload_distance = distance;
+            }
+        }
+        if (unload_island < 0) return routes;
+        load_islands.push_back(i);
+        unload_islands.push_back(unload_island);
+        route_locations.push_back(islands[i].location);
+        route_rates.push_back(tanker_capacity / (2. * unload_distance / tanker_speed + LOGISTICS_HANDLING_HOURS));
+        route_supplies.push_back(islands[i].fuel + islands[i].production_rate * horizon);
+    }
+    Fleet_plan plan(tanker_locations, route_locations, route_rates, route_supplies, tanker_speed, horizon);
+    for (int tanker = 0; tanker < int(tanker_locations.size()); tanker++) plan.add_tanker(tanker);
+    for (int tanker = 0; tanker < int(tanker_locations.size()); tanker++)
+    {
+        int route = plan.get_node(tanker);
+        if (route == int(load_islands.size())) continue;
+        routes[tanker].load_island = load_islands[route];
+        routes[tanker].unload_island = unload_islands[route];
+    }
+    return routes;
+}
+
+// plan the routes of all of the Model's tankers that can move over the supplied number
+// of hours, and give each tanker its new cargo destinations; a tanker that the plan
+// leaves idle is stopped, so that it does not keep drawing on fuel given to the others
+void assign_tanker_routes(int horizon)
+{
+    Model* model = Model::get_Instance();
+    vector<shared_ptr<Island>> islands;
+    vector<Logistics_island> island_states;
+    for (auto&& island_pair : model->get_islands())
+    {
+        islands.push_back(island_pair.second);
+        island_states.push_back(Logistics_island{island_pair.second->get_location(),
+                island_pair.second->get_fuel(), island_pair.second->get_production_rate()});
+    }
+    vector<shared_ptr<Tanker>> tankers;
+    vector<Point> tanker_locations;
+    for (auto&& ship_pair : model->get_ships())
+    {
+        shared_ptr<Tanker> tanker = dynamic_pointer_cast<Tanker>(ship_pair.second);
+        if (!tanker || !tanker->can_move()) continue;
+        tankers.push_back(tanker);
+        tanker_locations.push_back(tanker->get_location());
+    }
+    if (tankers.empty()) return;
+    // tankers are all alike, so the first speaks for the others
+    vector<Logistics_route> routes = plan_tanker_routes(tanker_locations, island_states,
+            tankers.front()->get_maximum_speed(), tankers.front()->get_cargo_capacity(), horizon);
+    for (int i = 0; i < int(tankers.size()); i++)
+    {
+        if (routes[i].load_island >= 0)
+            tankers[i]->set_cargo_destinations(islands[routes[i].load_island], islands[routes[i].unload_island]);
+        else if (tankers[i]->has_cargo_destinations()) tankers[i]->stop();
+    }
+}
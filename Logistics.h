@@ -0,0 +1,46 @@
+#ifndef LOGISTICS_H
+#define LOGISTICS_H
+
+#include "Geometry.h"
+#include <vector>
+
+/* Tanker logistics
+The logistics planner decides where every tanker of the fleet should load and unload,
+so that together they deliver as much fuel as they can over a planning horizon.
+
+Islands that produce fuel are the places to load, and each of them unloads at the
+nearest island that produces none. A tanker on a route delivers its cargo capacity
+once per round trip, but no more fuel can be carried away from an island than it has
+on hand plus what it produces over the horizon, so each further tanker on a route adds
+less than the one before, and the time a tanker spends sailing to its route is lost.
+Finding the routes is then a min-cost transport problem from the tankers to the routes,
+which is solved exactly by adding one tanker at a time along a shortest path of
+reassignments, with Dijkstra's algorithm over the routes. The time taken grows with
+the number of tankers times the square of the number of islands that produce fuel.
+*/
+
+// an island as seen by the planner
+struct Logistics_island {
+    Point location;
+    double fuel;
+    double production_rate;
+};
+
+// the islands a tanker should load and unload at, as indexes of the planner's islands;
+// both are -1 if the tanker cannot add to the fuel delivered
+struct Logistics_route {
+    int load_island = -1;
+    int unload_island = -1;
+};
+
+// return the route of each tanker, for tankers at the supplied locations that are all
+// alike, with the supplied speed in nm/hr and cargo capacity in tons
+std::vector<Logistics_route> plan_tanker_routes(const std::vector<Point>& tanker_locations,
+        const std::vector<Logistics_island>& islands, double tanker_speed, double tanker_capacity, double horizon);
+
+// plan the routes of all of the Model's tankers that can move over the supplied number
+// of hours, and give each tanker its new cargo destinations; a tanker that cannot add
+// to the fuel delivered is stopped, and its cargo destinations are cleared
+void assign_tanker_routes(int horizon);
+
+#endif
@@ -0,0 +1,41 @@
+#include "Mapped_file.h"
+#include "Utility.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// map the file into memory
+Mapped_file::Mapped_file(const string& filename, const char* error_msg) : begin(nullptr), end(nullptr)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) throw Error(error_msg);
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) < 0)
+    {
+        close(fd);
+        throw Error(error_msg);
+    }
+    size_t size = size_t(file_stat.st_size);
+    if (size > 0)
+    {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            close(fd);
+            throw Error(error_msg);
+        }
+        begin = static_cast<const char*>(mapping);
+        end = begin + size;
+    }
+    // the mapping stays valid after the file is closed
+    close(fd);
+}
+
+// unmap the file
+Mapped_file::~Mapped_file()
+{
+    if (begin) munmap(const_cast<char*>(begin), size_t(end - begin));
+}
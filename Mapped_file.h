@@ -0,0 +1,33 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+
+/* Mapped_file
+A Mapped_file maps the whole of a file into memory, read-only, for as long as it exists,
+so that its contents can be scanned in place instead of being read into buffers.
+*/
+
+class Mapped_file {
+public:
+    // map the file into memory; will throw Error(error_msg) if the file cannot be read
+    Mapped_file(const std::string& filename, const char* error_msg);
+    // unmap the file
+    ~Mapped_file();
+
+    // the contents of the file; begin is null if the file is empty
+    const char* get_begin() const
+        {return begin;}
+    const char* get_end() const
+        {return end;}
+
+    // disallow copy/move construction or assignment
+    Mapped_file(const Mapped_file&) = delete;
+    Mapped_file& operator=(const Mapped_file&) = delete;
+
+private:
+    const char* begin;
+    const char* end;
+};
+
+#endif
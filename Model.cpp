@@ -1,18 +1,52 @@
 #include "Model.h"
 #include "Ship.h"
+#include "Ship_state_store.h"
+#include "Combat_engine.h"
 #include "Island.h"
+#include "Island_registry.h"
 #include "View.h"
 #include "Ship_factory.h"
+#include "Worker_pool.h"
+#include "Output.h"
+#include "Navigation.h"
+#include "Snapshot.h"
+#include "Command_file.h"
+#include "Mapped_file.h"
+#include "Profiler.h"
 #include <iostream>
 #include <algorithm>
+#include <functional>
+#include <cassert>
 
 using namespace std;
-using namespace placeholders;
 
 const char* const ISLAND_NOT_FOUND_MSG = "Island not found!";
 const char* const SHIP_NOT_FOUND_MSG = "Ship not found!";
+// width of the cells of the spatial indexes, in nm
+const double MODEL_GRID_CELL_SIZE = 10.;
+// by default, a closest point of approach nearer than this range, in nm, within this many hours is a collision risk
+const double DEFAULT_COLLISION_RISK_RANGE = 1.;
+const double DEFAULT_COLLISION_RISK_HORIZON = 1.;
+const char* const INVALID_SNAPSHOT_MSG = "Invalid snapshot file!";
+// the kind of the records of islands; those of ships give the ship type
+const char* const SNAPSHOT_ISLAND_KIND = "Island";
+const char* const INVALID_SCENARIO_MSG = "Invalid scenario file!";
+
+// the world that the simulation starts with
+const char DEFAULT_SCENARIO[] =
+    "island Exxon 10 10 1000 200\n"
+    "island Shell 0 30 1000 200\n"
+    "island Bermuda 20 20 0 0\n"
+    "island Treasure_Island 50 5 100 5\n"
+    "ship Ajax Cruiser 15 15\n"
+    "ship Xerxes Cruiser 25 25\n"
+    "ship Valdez Tanker 30 30\n";
 
 Model *Model::model = 0;
+vector<string> Model::id_names;
+map<string, int> Model::name_ids;
+vector<int> Model::ids_by_name;
+vector<int> Model::unordered_ids;
 
 Model* Model::get_Instance() {
     if (!model) model = new Model;
@@ -20,27 +54,13 @@ Model* Model::get_Instance() {
 }
 
 // create the initial objects, output constructor message
-Model::Model() : time(0)
+Model::Model() : time(0), running_events(false), collision_risks_change(0),
+    collision_risk_range(DEFAULT_COLLISION_RISK_RANGE), collision_risk_horizon(DEFAULT_COLLISION_RISK_HORIZON), name_index(SHORTEN_NAME_LENGTH), island_version(0), island_grid(MODEL_GRID_CELL_SIZE, get_name_of_id), ship_grid(MODEL_GRID_CELL_SIZE, get_name_of_id), change_count(0), newest_changed_id(-1)
 {
-    Model::Island_ptr exxon = make_shared<Island>("Exxon", Point(10, 10), 1000, 200);
-    Model::Island_ptr shell = make_shared<Island>("Shell", Point(0, 30), 1000, 200);
-    Model::Island_ptr bermuda = make_shared<Island>("Bermuda", Point(20, 20));
-    Model::Island_ptr treasure_island = make_shared<Island>("Treasure_Island", Point(50, 5), 100, 5);
-
-    islands[exxon->get_name()] = exxon;
-    objects[exxon->get_name()] = exxon;
-    islands[shell->get_name()] = shell;
-    objects[shell->get_name()] = shell;
-    islands[bermuda->get_name()] = bermuda;
-    objects[bermuda->get_name()] = bermuda;
-    islands[treasure_island->get_name()] = treasure_island;
-    objects[treasure_island->get_name()] = treasure_island;
+    Command_file scenario(DEFAULT_SCENARIO, DEFAULT_SCENARIO + sizeof(DEFAULT_SCENARIO) - 1);
+    add_scenario(scenario);
 
-    add_ship(create_ship("Ajax", "Cruiser", Point (15, 15)));
-    add_ship(create_ship("Xerxes", "Cruiser", Point (25, 25)));
-    add_ship(create_ship("Valdez", "Tanker", Point (30, 30)));
-
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Model constructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Model constructed" << '\n';
 }
 
 // destroy all objects, output destructor message
@@ -49,50 +69,701 @@ Model::~Model()
     objects.clear();
     ships.clear();
     islands.clear();
+    name_index.clear();
+    ship_index.clear();
+    island_index.clear();
+    ships_by_id.clear();
     views.clear();
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Model destructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Model destructed" << '\n';
+}
+
+// return the ID of the name, assigning the next unused one if it has none yet
+int Model::intern_name(const std::string& name)
+{
+    auto name_it = name_ids.find(name);
+    if (name_it != name_ids.end()) return name_it->second;
+    int id = int(id_names.size());
+    id_names.push_back(name);
+    name_ids[name] = id;
+    unordered_ids.push_back(id);
+    return id;
+}
+// the IDs assigned since the last call are put in order and merged in all at once,
+// so that assigning many names costs one sort rather than an insertion for each
+const vector<int>& Model::get_ids_in_name_order()
+{
+    if (unordered_ids.empty()) return ids_by_name;
+    auto name_less = [](int first, int second){return id_names[first] < id_names[second];};
+    sort(unordered_ids.begin(), unordered_ids.end(), name_less);
+    size_t ordered_count = ids_by_name.size();
+    ids_by_name.insert(ids_by_name.end(), unordered_ids.begin(), unordered_ids.end());
+    inplace_merge(ids_by_name.begin(), ids_by_name.begin() + ordered_count, ids_by_name.end(), name_less);
+    unordered_ids.clear();
+    return ids_by_name;
 }
 
 // will throw Error("Island not found!") if no island of that name
 Model::Island_ptr Model::get_island_ptr(const std::string& name) const
 {
-    auto island_it = islands.find(name);
-    if (island_it == islands.end()) throw Error(ISLAND_NOT_FOUND_MSG);
-    return (*island_it).second;
+    const Island_ptr* island = island_index.find(name);
+    if (!island) throw Error(ISLAND_NOT_FOUND_MSG);
+    return *island;
+}
+
+// add a new island to the lists, and update the view
+void Model::add_island(Model::Island_ptr island)
+{
+    insert_island(island);
+    island_grid.update(island->get_id(), island->get_location());
+    notify_location_island(island->get_id(), island->get_location());
 }
 
 // add a new ship to the list, and update the view
 void Model::add_ship(Model::Ship_ptr ship)
 {
-    ships[ship->get_name()] = ship;
-    objects[ship->get_name()] = ship;
-    notify_location_ship(ship->get_name(), ship->get_location());
+    insert_ship(ship);
+    notify_location_ship(ship->get_id(), ship->get_location());
 }
 // will throw Error("Ship not found!") if no ship of that name
 Model::Ship_ptr Model::get_ship_ptr(const std::string& name) const
 {
-    auto ship_it = ships.find(name);
-    if (ship_it == ships.end()) throw Error(SHIP_NOT_FOUND_MSG);
-    return (*ship_it).second;
+    const Ship_ptr* ship = ship_index.find(name);
+    if (!ship) throw Error(SHIP_NOT_FOUND_MSG);
+    return *ship;
 }
+// the ship is only marked here, so that the containers do not change while the objects
+// are being updated
 void Model::remove_ship(shared_ptr<Ship> ship)
 {
-    auto ship_it = ships.find(ship->get_name());
-    if (ship_it == ships.end()) throw Error(SHIP_NOT_FOUND_MSG);
-    ships.erase(ship_it);
-    objects.erase(ship->get_name());
+    if (!ship_index.find(ship->get_name())) throw Error(SHIP_NOT_FOUND_MSG);
+    int id = ship->get_id();
+    if (is_removal_pending(id)) return;
+    if (id >= int(removal_pending.size())) removal_pending.resize(id + 1, false);
+    removal_pending[id] = true;
+    removed_ships.push_back(ship);
+}
+
+// take the removed ships out of the containers and indexes all at once; the name-ordered
+// maps are each gone through once, erasing the ships in name order as they are reached.
+// Each ship is still reported gone on its own: notify_gone only records the change, and
+// the Views pick up all of them together when they are next refreshed.
+void Model::remove_pending_ships()
+{
+    if (removed_ships.empty()) return;
+    sort(removed_ships.begin(), removed_ships.end(),
+            [](const Ship_ptr& first, const Ship_ptr& second){return first->get_name() < second->get_name();});
+    auto ship_it = ships.begin();
+    auto object_it = objects.begin();
+    for (auto&& ship : removed_ships)
+    {
+        const string& name = ship->get_name();
+        notify_gone(ship->get_id());
+        removal_pending[ship->get_id()] = false;
+        ships_by_id[ship->get_id()].reset();
+        ship_index.erase(name);
+        name_index.erase(name);
+        ship_grid.remove(ship->get_id());
+        event_times.erase(name);
+        while (ship_it->first < name) ++ship_it;
+        assert(ship_it->first == name);
+        ship_it = ships.erase(ship_it);
+        while (objects.key_comp()(object_it->first, name)) ++object_it;
+        object_it = objects.erase(object_it);
+    }
+    removed_ships.clear();
+}
+
+// add the object to the containers and indexes
+void Model::insert_island(Island_ptr island)
+{
+    islands[island->get_name()] = island;
+    objects[island->get_name()] = island;
+    island_index.insert(island->get_name(), island);
+    name_index.insert(island->get_name(), island);
+    ++island_version;
+}
+
+// return the registry of the current islands, making a new one if they have changed
+shared_ptr<const Island_registry> Model::get_island_registry() const
+{
+    if (!island_registry || island_registry->get_version() != island_version)
+    {
+        vector<Island_ptr> islands_in_order;
+        islands_in_order.reserve(islands.size());
+        for (auto&& island_pair : islands) islands_in_order.push_back(island_pair.second);
+        island_registry = make_shared<const Island_registry>(move(islands_in_order), island_version);
+    }
+    return island_registry;
+}
+void Model::insert_ship(Ship_ptr ship)
+{
+    ships[ship->get_name()] = ship;
+    objects[ship->get_name()] = ship;
+    ship_index.insert(ship->get_name(), ship);
+    name_index.insert(ship->get_name(), ship);
+    index_ship_by_id(ship);
+}
+// make the ship the one found for its ID
+void Model::index_ship_by_id(Ship_ptr ship)
+{
+    int id = ship->get_id();
+    if (id >= int(ships_by_id.size())) ships_by_id.resize(id + 1);
+    ships_by_id[id] = ship;
+}
+
+Model::Object_containers::Object_containers() :
+    name_index(SHORTEN_NAME_LENGTH), island_grid(MODEL_GRID_CELL_SIZE, get_name_of_id), ship_grid(MODEL_GRID_CELL_SIZE, get_name_of_id)
+{}
+
+// exchange the current objects with the supplied ones, without telling the Views
+void Model::swap_objects(Object_containers& other)
+{
+    swap(islands, other.islands);
+    swap(ships, other.ships);
+    swap(objects, other.objects);
+    swap(island_index, other.island_index);
+    swap(ship_index, other.ship_index);
+    swap(name_index, other.name_index);
+    swap(ships_by_id, other.ships_by_id);
+    swap(island_grid, other.island_grid);
+    swap(ship_grid, other.ship_grid);
+}
+
+/* Proximity queries */
+// return the island nearest to location whose name is accepted by the supplied function,
+// or an empty pointer if there is none
+Model::Island_ptr Model::find_nearest_island(Point location, const function<bool(const string&)>& accept) const
+{
+    vector<Spatial_grid::Entry> nearest = island_grid.find_nearest(location, 1,
+            [&accept](const Spatial_grid::Entry& entry){return accept(id_names[entry.id]);});
+    if (nearest.empty()) return Island_ptr();
+    return get_island_ptr(id_names[nearest.front().id]);
+}
+// return the ships whose distance from location is less than or equal to radius
+vector<Model::Ship_ptr> Model::find_ships_in_radius(Point location, double radius)
+{
+    bring_ships_up_to_date();
+    vector<Ship_ptr> result;
+    for (auto&& entry : ship_grid.find_in_radius(location, radius)) result.push_back(ships_by_id[entry.id]);
+    return result;
+}
+// return up to k ships that are accepted by the supplied function, nearest to location first;
+// the grid entries hold the ships' IDs, so each candidate is found without a name lookup
+vector<Model::Ship_ptr> Model::find_nearest_ships(Point location, int k, const function<bool(const Ship&)>& accept,
+        double max_distance)
+{
+    bring_ships_up_to_date();
+    vector<Ship_ptr> result;
+    for (auto&& entry : ship_grid.find_nearest(location, k,
+            [this, &accept](const Spatial_grid::Entry& entry){return accept(*ships_by_id[entry.id]);}, max_distance))
+        result.push_back(ships_by_id[entry.id]);
+    return result;
 }
 
 // tell all objects to describe themselves
 void Model::describe() const
 {
-    for_each(objects.begin(), objects.end(), [](pair<string, Sim_object_ptr> pair){pair.second->describe();});
+    for_each(objects.begin(), objects.end(), [](const Sim_object_map::value_type& pair){pair.second->describe();});
 }
 // increment the time, and tell all objects to update themselves
 void Model::update()
 {
+    PROFILE_TICK();
+    // in quiet mode, the objects' messages are discarded
+    Quiet_output_guard quiet_guard;
     ++time;
-    for_each(objects.begin(), objects.end(), [](pair<string, Sim_object_ptr> pair){pair.second->update();});
+    // move all of the moving ships in one pass, split across the workers if there are any;
+    // each ship commits its move during its own update, so output stays in name order
+    Ship_state_store* store = Ship_state_store::get_Instance();
+    if (workers) workers->parallel_for(store->get_size(), [store](int begin, int end){store->compute_moves(begin, end);});
+    else store->compute_moves();
+    // with the moves known, decide which attackers will have their targets in range
+    resolve_ranges();
+    for (auto&& object_pair : objects)
+    {
+        if (!is_removal_pending(object_pair.second->get_id())) object_pair.second->update();
+    }
+    store->discard_moves();
+    Combat_engine::get_Instance()->discard_resolutions();
+    remove_pending_ships();
+    find_collision_risks();
+    refresh_tick_views();
+}
+
+// advance the time to end_time, jumping over the hours in which no object
+// does more than steady progress. Each object schedules its next event; all of the
+// hours before the earliest one are skipped at once, and in the hour of the event
+// only the objects that have one are updated, in name order. The others are left
+// where they were, and bring_up_to_date advances one in closed form when it is
+// read or changed by another object; all of them are brought up to date at the end.
+// The range checks are not resolved in advance here, since the targets may not have
+// been brought up to date; each attacker checks its target directly.
+void Model::run_until(int end_time)
+{
+    if (end_time < time) throw Error("Time must not be earlier than the current time!");
+    Quiet_output_guard quiet_guard;
+    event_queue = decltype(event_queue)();
+    event_times.clear();
+    advanced_times.assign(id_names.size(), time);
+    running_events = true;
+    try
+    {
+        for (auto&& object_pair : objects) schedule_event(object_pair.second);
+        while (time < end_time)
+        {
+            // skip ahead to the hour before the next event, unless a View records every tick
+            int next_time = event_queue.empty() ? end_time : min(event_queue.top().first, end_time);
+            if (next_time - 1 > time && !has_tick_views()) time = next_time - 1;
+            PROFILE_TICK();
+            ++time;
+            // collect the objects whose current event is in this hour
+            due_objects.clear();
+            while (!event_queue.empty() && event_queue.top().first <= time)
+            {
+                Event event = event_queue.top();
+                event_queue.pop();
+                auto time_it = event_times.find(event.second);
+                if (time_it == event_times.end() || time_it->second != event.first) continue;
+                event_times.erase(time_it);
+                due_objects.insert(event.second);
+            }
+            // an object rescheduled into this hour while it is processed is reached in turn
+            for (auto&& name : due_objects)
+            {
+                const Sim_object_ptr* object = name_index.find(name);
+                if (!object || is_removal_pending((*object)->get_id())) continue;
+                advance_to(**object, time - 1);
+                advanced_times[(*object)->get_id()] = time;
+                event_cursor = name;
+                (*object)->update();
+            }
+            event_cursor.clear();
+            Ship_state_store::get_Instance()->discard_moves();
+            remove_pending_ships();
+            for (auto&& name : due_objects)
+            {
+                if (const Sim_object_ptr* object = name_index.find(name)) schedule_event(*object);
+            }
+            if (has_tick_views())
+            {
+                for (auto&& object_pair : objects) advance_to(*object_pair.second, time);
+                refresh_tick_views();
+            }
+        }
+    }
+    catch (...)
+    {
+        end_events();
+        throw;
+    }
+    end_events();
+    find_collision_risks();
+}
+
+// during run_until, bring the object to where it would be at this point of the hour:
+// the objects up to the one being updated, in name order, have made this hour's progress
+void Model::bring_up_to_date(Sim_object& object)
+{
+    if (!running_events) return;
+    bool processed = !event_cursor.empty() && object.get_name() <= event_cursor;
+    advance_to(object, processed ? time : time - 1);
+}
+
+// make the steady progress of the object from the time it was last advanced to target_time
+void Model::advance_to(Sim_object& object, int target_time)
+{
+    int& advanced_time = advanced_times[object.get_id()];
+    if (advanced_time >= target_time) return;
+    object.advance_quietly(target_time - advanced_time);
+    advanced_time = target_time;
+}
+
+// during run_until, bring every ship up to date; the spatial index holds each ship's
+// location as of when it was last advanced
+void Model::bring_ships_up_to_date()
+{
+    if (!running_events) return;
+    for (auto&& ship_pair : ships) bring_up_to_date(*ship_pair.second);
+}
+
+// finish run_until, bringing every object up to the current time
+void Model::end_events()
+{
+    running_events = false;
+    event_cursor.clear();
+    for (auto&& object_pair : objects) advance_to(*object_pair.second, time);
+    Ship_state_store::get_Instance()->discard_moves();
+    due_objects.clear();
+    event_times.clear();
+    event_queue = decltype(event_queue)();
+}
+
+// resolve the range checks of all engagements for the coming tick, split across the
+// workers if there are any; every pending move has already been computed
+void Model::resolve_ranges()
+{
+    PROFILE_SCOPE(PROFILE_COMBAT_RESOLVE);
+    Combat_engine* combat = Combat_engine::get_Instance();
+    if (workers)
+    {
+        workers->parallel_for(combat->get_engagement_count(), [combat](int begin, int end){combat->resolve_ranges(begin, end);});
+        combat->set_resolved();
+    }
+    else combat->resolve_ranges();
+}
+
+// an object's state was changed by another object, so recompute its next event
+void Model::reschedule(const std::string& name)
+{
+    if (!running_events) return;
+    // an object not yet processed in this hour is updated in it, as it would be in update()
+    if (!event_cursor.empty() && name > event_cursor)
+    {
+        due_objects.insert(name);
+        return;
+    }
+    if (const Sim_object_ptr* object = name_index.find(name)) schedule_event(*object);
+}
+
+// put the object's next event into the queue, if it has one
+void Model::schedule_event(Sim_object_ptr object)
+{
+    int delay = object->get_next_event_delay();
+    if (delay >= NO_EVENT_DELAY)
+    {
+        event_times.erase(object->get_name());
+        return;
+    }
+    event_times[object->get_name()] = time + delay;
+    event_queue.push(Event(time + delay, object->get_name()));
+}
+
+// find the collision risks for the current state of the ships. Two ships cannot come
+// within the risk range in the horizon time if they are farther apart than the range
+// plus the distance both can sail in that time, so each moving ship is compared only
+// with the ships within that distance of it, all at once with compute_CPA_batch.
+void Model::find_collision_risks()
+{
+    collision_risks.clear();
+    double max_speed = 0.;
+    for (auto&& ship_pair : ships)
+    {
+        if (ship_pair.second->is_moving()) max_speed = max(max_speed, ship_pair.second->get_speed());
+    }
+    vector<double> target_x, target_y, target_velocity_x, target_velocity_y, CPA_range, time_to_CPA;
+    vector<Ship*> targets;
+    for (auto&& ship_pair : ships)
+    {
+        Ship* ship = ship_pair.second.get();
+        if (!ship->is_moving()) continue;
+        double search_radius = collision_risk_range + collision_risk_horizon * (ship->get_speed() + max_speed);
+        targets.clear();
+        target_x.clear();
+        target_y.clear();
+        target_velocity_x.clear();
+        target_velocity_y.clear();
+        ship_grid.for_each_in_radius(ship->get_location(), search_radius, [&](const Spatial_grid::Entry& entry)
+        {
+            Ship* target = ships_by_id[entry.id].get();
+            assert(target);
+            // a pair of moving ships is screened once, from the first by name
+            if (target == ship || (target->is_moving() && id_names[entry.id] < ship_pair.first)) return;
+            Cartesian_vector velocity = target->is_moving() ? target->get_velocity() : Cartesian_vector();
+            targets.push_back(target);
+            target_x.push_back(entry.location.x);
+            target_y.push_back(entry.location.y);
+            target_velocity_x.push_back(velocity.delta_x);
+            target_velocity_y.push_back(velocity.delta_y);
+        });
+        int count = int(targets.size());
+        CPA_range.resize(count);
+        time_to_CPA.resize(count);
+        compute_CPA_batch(ship->get_location(), Course_speed(ship->get_course(), ship->get_speed()), count,
+                target_x.data(), target_y.data(), target_velocity_x.data(), target_velocity_y.data(),
+                CPA_range.data(), nullptr, time_to_CPA.data());
+        for (int i = 0; i < count; i++)
+        {
+            if (CPA_range[i] >= collision_risk_range || time_to_CPA[i] > collision_risk_horizon) continue;
+            // put the ships of the pair in name order
+            Collision_risk risk{ship->get_id(), targets[i]->get_id(), CPA_range[i], time_to_CPA[i]};
+            if (targets[i]->get_name() < ship->get_name()) swap(risk.ship_id, risk.other_id);
+            collision_risks.push_back(risk);
+        }
+    }
+    sort(collision_risks.begin(), collision_risks.end(), [](const Collision_risk& first, const Collision_risk& second)
+    {
+        if (first.ship_id != second.ship_id) return id_names[first.ship_id] < id_names[second.ship_id];
+        return id_names[first.other_id] < id_names[second.other_id];
+    });
+    collision_risks_change = ++change_count;
+}
+
+// set the risk range and horizon, and screen the ships again with them
+void Model::set_collision_risk_limits(double range, double horizon)
+{
+    if (range <= 0. || horizon <= 0.) throw Error("Collision risk range and horizon must be positive!");
+    collision_risk_range = range;
+    collision_risk_horizon = horizon;
+    find_collision_risks();
+}
+
+/* Snapshots */
+// the islands come first, so that the ships' references to them can be resolved as
+// the ships are restored; the records of each are in name order
+void Model::save(const string& filename) const
+{
+    Snapshot_writer writer;
+    writer.write_int(time);
+    writer.write_int(int(islands.size()));
+    for (auto&& island_pair : islands)
+    {
+        writer.begin_record();
+        writer.write_string(SNAPSHOT_ISLAND_KIND);
+        writer.write_string(island_pair.first);
+        writer.write_point(island_pair.second->get_location());
+        island_pair.second->save_state(writer);
+        writer.end_record();
+    }
+    writer.write_int(int(ships.size()));
+    for (auto&& ship_pair : ships)
+    {
+        writer.begin_record();
+        writer.write_string(ship_pair.second->get_type_name());
+        writer.write_string(ship_pair.first);
+        writer.write_point(ship_pair.second->get_location());
+        ship_pair.second->save_state(writer);
+        writer.end_record();
+    }
+    writer.write_file(filename);
+}
+
+// The file is read twice. The first pass steps over every record, checking its kind and
+// name, before anything is changed. The second builds the objects in place of the current
+// ones, which are set aside: the islands first, since cruise ships learn the islands when
+// they are created, and then the state of each ship once all of them exist, since warships
+// refer to their targets. Only when every object is restored are the current ones discarded
+// and the Views told of the change; if any object cannot be restored, the objects built so
+// far are discarded instead, and the current ones put back.
+void Model::load(const string& filename)
+{
+    Snapshot_reader reader(filename);
+    const char* start = reader.tell();
+    reader.read_int();
+    Name_table<bool> names(SHORTEN_NAME_LENGTH);
+    for (bool is_island : {true, false})
+    {
+        int count = reader.read_int();
+        if (count < 0) throw Error(INVALID_SNAPSHOT_MSG);
+        for (int i = 0; i < count; i++)
+        {
+            reader.begin_record();
+            string kind = reader.read_string();
+            string name = reader.read_string();
+            if (is_island ? kind != SNAPSHOT_ISLAND_KIND : !is_ship_type(kind)) throw Error(INVALID_SNAPSHOT_MSG);
+            if (name.size() < SHORTEN_NAME_LENGTH || !names.insert(name, true)) throw Error(INVALID_SNAPSHOT_MSG);
+            reader.end_record();
+        }
+    }
+    if (!reader.at_end()) throw Error(INVALID_SNAPSHOT_MSG);
+
+    Object_containers current_objects;
+    swap_objects(current_objects);
+    // the objects built so far are destroyed with current_objects
+    auto put_back_objects = [this, &current_objects]()
+    {
+        swap_objects(current_objects);
+        ++island_version;
+        island_registry.reset();
+    };
+    reader.seek(start);
+    int loaded_time = reader.read_int();
+    try
+    {
+        int island_count = reader.read_int();
+        for (int i = 0; i < island_count; i++)
+        {
+            reader.begin_record();
+            reader.read_string();
+            string name = reader.read_string();
+            Island_ptr island = make_shared<Island>(name, reader.read_point());
+            island->restore_state(reader);
+            insert_island(island);
+            island_grid.update(island->get_id(), island->get_location());
+            reader.end_record();
+        }
+        int ship_count = reader.read_int();
+        const char* ship_records = reader.tell();
+        for (int i = 0; i < ship_count; i++)
+        {
+            reader.begin_record();
+            string type = reader.read_string();
+            string name = reader.read_string();
+            insert_ship(create_ship(name, type, reader.read_point()));
+            reader.end_record();
+        }
+        reader.seek(ship_records);
+        for (int i = 0; i < ship_count; i++)
+        {
+            reader.begin_record();
+            reader.read_string();
+            Ship_ptr ship = get_ship_ptr(reader.read_string());
+            reader.read_point();
+            ship->restore_state(reader);
+            reader.end_record();
+        }
+    }
+    catch (Error&)
+    {
+        // a reference to an object that is not in the file is reported as an invalid file
+        put_back_objects();
+        throw Error(INVALID_SNAPSHOT_MSG);
+    }
+    catch (...)
+    {
+        put_back_objects();
+        throw;
+    }
+
+    time = loaded_time;
+    for (auto&& object_pair : current_objects.objects) notify_gone(object_pair.second->get_id());
+    removed_ships.clear();
+    removal_pending.clear();
+    for (auto&& island_pair : islands) notify_location_island(island_pair.second->get_id(), island_pair.second->get_location());
+    for (auto&& ship_pair : ships) ship_pair.second->broadcast_current_state();
+    find_collision_risks();
+}
+
+/* Scenarios */
+void Model::load_scenario(const string& filename)
+{
+    Mapped_file file(filename, "Could not open scenario file!");
+    Command_file scenario(file.get_begin(), file.get_end());
+    add_scenario(scenario);
+    find_collision_risks();
+}
+
+// replace the current objects with those of the scenario being scanned. The lines are
+// all read and checked first; the numbers are read as cin would read them, so nan and
+// inf are rejected like any other malformed number. Then the islands are created,
+// before the ships since cruise ships learn the islands when they are created. The
+// containers are built from the objects in name order, which adds each at the end,
+// and the spatial indexes and Views are told about the objects once all of them are
+// in place.
+void Model::add_scenario(Command_file& scenario)
+{
+    struct Island_line {
+        string name;
+        Point location;
+        double fuel, production_rate;
+    };
+    struct Ship_line {
+        string name, type;
+        Point location;
+    };
+    vector<Island_line> island_lines;
+    vector<Ship_line> ship_lines;
+    // names that are the same in their leading characters are in use twice
+    Name_table<bool> names(SHORTEN_NAME_LENGTH);
+    string kind;
+    while (scenario.read_word(kind))
+    {
+        if (kind[0] == '#')
+        {
+            scenario.skip_line();
+            continue;
+        }
+        string name;
+        if (!scenario.read_word(name) || name.size() < SHORTEN_NAME_LENGTH || !names.insert(name, true))
+            throw Error(INVALID_SCENARIO_MSG);
+        double x, y;
+        if (kind == "island")
+        {
+            Island_line line;
+            line.name = name;
+            if (!scenario.read_double(x) || !scenario.read_double(y) ||
+                    !scenario.read_double(line.fuel) || !scenario.read_double(line.production_rate) ||
+                    line.fuel < 0. || line.production_rate < 0.) throw Error(INVALID_SCENARIO_MSG);
+            line.location = Point(x, y);
+            island_lines.push_back(line);
+        }
+        else if (kind == "ship")
+        {
+            Ship_line line;
+            line.name = name;
+            if (!scenario.read_word(line.type) || !is_ship_type(line.type) ||
+                    !scenario.read_double(x) || !scenario.read_double(y)) throw Error(INVALID_SCENARIO_MSG);
+            line.location = Point(x, y);
+            ship_lines.push_back(line);
+        }
+        else throw Error(INVALID_SCENARIO_MSG);
+    }
+
+    sort(island_lines.begin(), island_lines.end(), [](const Island_line& first, const Island_line& second)
+            {return first.name < second.name;});
+    sort(ship_lines.begin(), ship_lines.end(), [](const Ship_line& first, const Ship_line& second)
+            {return first.name < second.name;});
+
+    clear_objects();
+    time = 0;
+    vector<Island_ptr> new_islands;
+    new_islands.reserve(island_lines.size());
+    for (auto&& line : island_lines)
+    {
+        new_islands.push_back(make_shared<Island>(line.name, line.location, line.fuel, line.production_rate));
+        islands.insert(islands.end(), make_pair(line.name, new_islands.back()));
+        island_index.insert(line.name, new_islands.back());
+        name_index.insert(line.name, new_islands.back());
+    }
+    ++island_version;
+    vector<Ship_ptr> new_ships;
+    new_ships.reserve(ship_lines.size());
+    for (auto&& line : ship_lines)
+    {
+        new_ships.push_back(create_ship(line.name, line.type, line.location));
+        ships.insert(ships.end(), make_pair(line.name, new_ships.back()));
+        ship_index.insert(line.name, new_ships.back());
+        name_index.insert(line.name, new_ships.back());
+        index_ship_by_id(new_ships.back());
+    }
+    vector<Sim_object_ptr> new_objects(new_islands.begin(), new_islands.end());
+    new_objects.insert(new_objects.end(), new_ships.begin(), new_ships.end());
+    inplace_merge(new_objects.begin(), new_objects.begin() + new_islands.size(), new_objects.end(),
+            [](const Sim_object_ptr& first, const Sim_object_ptr& second){return first->get_name() < second->get_name();});
+    for (auto&& object : new_objects) objects.insert(objects.end(), make_pair(object->get_name(), object));
+
+    for (auto&& island : new_islands)
+    {
+        island_grid.update(island->get_id(), island->get_location());
+        notify_location_island(island->get_id(), island->get_location());
+    }
+    for (auto&& ship : new_ships) notify_location_ship(ship->get_id(), ship->get_location());
+}
+
+// discard every object, telling the Views that they are gone
+void Model::clear_objects()
+{
+    for (auto&& object_pair : objects) notify_gone(object_pair.second->get_id());
+    removed_ships.clear();
+    removal_pending.clear();
+    objects.clear();
+    ships.clear();
+    islands.clear();
+    name_index.clear();
+    ship_index.clear();
+    island_index.clear();
+    ships_by_id.clear();
+    ++island_version;
+    island_registry.reset();
+    island_grid.clear();
+    ship_grid.clear();
+}
+
+// use the supplied number of threads for the movement of ships in update
+void Model::set_thread_count(int count)
+{
+    if (count < 1) throw Error("Thread count must be positive!");
+    if (count == 1) workers.reset();
+    else workers.reset(new Worker_pool(count));
 }
 
 /* View services */
@@ -100,38 +771,132 @@ void Model::update()
 // with all current objects' locations (or other state information).
 void Model::attach(shared_ptr<View> view)
 {
-    views.push_back(view);
-    for_each(objects.begin(), objects.end(), [view](pair<string, Sim_object_ptr> pair){pair.second->broadcast_current_state();});
+    // the view starts from the current count, and the objects then record their state anew;
+    // the collision risks already found are given to it directly
+    views.push_back(View_record{view, change_count});
+    view->update_collision_risks(collision_risks);
+    for_each(objects.begin(), objects.end(), [view](const Sim_object_map::value_type& pair){pair.second->broadcast_current_state();});
 }
 // Detach the View by discarding the supplied pointer from the container of Views
 // - no updates sent to it thereafter.
 void Model::detach(shared_ptr<View> view)
 {
-    views.erase(find(views.begin(), views.end(), view));
+    views.erase(find_if(views.begin(), views.end(), [view](const View_record& record){return record.view == view;}));
+}
+
+// send the attached View the changes made since it was last refreshed; the objects
+// changed since then are at the newest end of the list, and are sent in the order of
+// their latest change
+void Model::refresh_view(shared_ptr<View> view)
+{
+    PROFILE_SCOPE(PROFILE_MODEL_REFRESH_VIEW);
+    auto record_it = find_if(views.begin(), views.end(), [view](const View_record& record){return record.view == view;});
+    assert(record_it != views.end());
+    unsigned long refreshed_change = record_it->refreshed_change;
+    int first_id = -1;
+    for (int id = newest_changed_id; id >= 0 && notified_states[id].latest_change > refreshed_change;
+            id = notified_states[id].older_id)
+        first_id = id;
+    for (int id = first_id; id >= 0; id = notified_states[id].newer_id)
+    {
+        const Notified_state& state = notified_states[id];
+        // if the object was gone since the refresh, the view sees its last location and its
+        // removal, and then only the parts notified after that (if the name was reused)
+        unsigned long since_change = refreshed_change;
+        if (state.gone_change > refreshed_change)
+        {
+            view->update_location_ship(id, state.gone_location);
+            view->update_remove_ship(id);
+            since_change = state.gone_change;
+        }
+        if (state.location_change > since_change)
+        {
+            if (state.is_island) view->update_location_island(id, state.location);
+            else view->update_location_ship(id, state.location);
+        }
+        if (state.course_speed_change > since_change) view->update_course_and_speed(id, state.course, state.speed);
+        if (state.fuel_change > since_change) view->update_fuel(id, state.fuel);
+    }
+    if (collision_risks_change > refreshed_change) view->update_collision_risks(collision_risks);
+    record_it->refreshed_change = change_count;
+}
+
+// is any attached View refreshed at the end of every tick?
+bool Model::has_tick_views() const
+{
+    return any_of(views.begin(), views.end(), [](const View_record& record){return record.view->is_refreshed_every_tick();});
+}
+
+// refresh the Views that are refreshed at the end of every tick, and tell them that it has ended
+void Model::refresh_tick_views()
+{
+    for (auto&& record : views)
+    {
+        if (!record.view->is_refreshed_every_tick()) continue;
+        refresh_view(record.view);
+        record.view->end_tick(time);
+    }
 }
 
 // notify the views about a ship's location
-void Model::notify_location_ship(const std::string &name, Point location)
+void Model::notify_location_ship(int id, Point location)
 {
-    for_each(views.begin(), views.end(), bind(&View::update_location_ship, _1, name, location));
+    PROFILE_SCOPE(PROFILE_MODEL_NOTIFY);
+    ship_grid.update(id, location);
+    Notified_state& state = record_change(id);
+    state.location = location;
+    state.is_island = false;
+    state.location_change = change_count;
 }
 // notify the views about an island's location
-void Model::notify_location_island(const std::string &name, Point location)
+void Model::notify_location_island(int id, Point location)
 {
-    for_each(views.begin(), views.end(), bind(&View::update_location_island, _1, name, location));
+    PROFILE_SCOPE(PROFILE_MODEL_NOTIFY);
+    Notified_state& state = record_change(id);
+    state.location = location;
+    state.is_island = true;
+    state.location_change = change_count;
 }
 // notify the views that an object is now gone
-void Model::notify_gone(const std::string& name)
+void Model::notify_gone(int id)
 {
-    for_each(views.begin(), views.end(), bind(&View::update_remove_ship, _1, name));
+    PROFILE_SCOPE(PROFILE_MODEL_NOTIFY);
+    Notified_state& state = record_change(id);
+    state.gone_location = state.location;
+    state.gone_change = change_count;
 }
 // notify the views that a ship has changed fuel
-void Model::notify_fuel(const std::string& name, double fuel)
+void Model::notify_fuel(int id, double fuel)
 {
-    for_each(views.begin(), views.end(), bind(&View::update_fuel, _1, name, fuel));
+    PROFILE_SCOPE(PROFILE_MODEL_NOTIFY);
+    Notified_state& state = record_change(id);
+    state.fuel = fuel;
+    state.fuel_change = change_count;
 }
 // notify the views that a ship has changed course and speed
-void Model::notify_course_speed(const std::string& name, double course, double speed)
+void Model::notify_course_speed(int id, double course, double speed)
+{
+    PROFILE_SCOPE(PROFILE_MODEL_NOTIFY);
+    Notified_state& state = record_change(id);
+    state.course = course;
+    state.speed = speed;
+    state.course_speed_change = change_count;
+}
+
+// return the notified state of the object, making room for it if needed,
+// and count a new change
+Model::Notified_state& Model::record_change(int id)
 {
-    for_each(views.begin(), views.end(), bind(&View::update_course_and_speed, _1, name, course, speed));
-}
\ No newline at end of file
+    if (id >= int(notified_states.size())) notified_states.resize(id + 1);
+    Notified_state& state = notified_states[id];
+    state.latest_change = ++change_count;
+    if (id == newest_changed_id) return state;
+    // unlink the object, if it is in the list, and put it at the newest end
+    if (state.older_id >= 0) notified_states[state.older_id].newer_id = state.newer_id;
+    if (state.newer_id >= 0) notified_states[state.newer_id].older_id = state.older_id;
+    state.older_id = newest_changed_id;
+    state.newer_id = -1;
+    if (newest_changed_id >= 0) notified_states[newest_changed_id].newer_id = id;
+    newest_changed_id = id;
+    return state;
+}
@@ -3,15 +3,31 @@
 
 #include "Geometry.h"
 #include "Utility.h"
+#include "Spatial_grid.h"
+#include "Name_table.h"
 #include <string>
 #include <map>
+#include <set>
 #include <vector>
+#include <queue>
 #include <memory>
+#include <functional>
 
 class Sim_object;
 class Ship;
 class Island;
 class View;
+class Worker_pool;
+class Command_file;
+class Island_registry;
+
+// a pair of ships whose closest point of approach is dangerously near
+struct Collision_risk {
+	int ship_id;
+	int other_id;
+	double range;	// range at the closest point of approach, in nm
+	double time;	// hours until the closest point of approach
+};
 
 /*
 Model is part of a simplified Model-View-Controller pattern.
@@ -19,7 +35,7 @@ Model keeps track of the Sim_objects in our little world. It is the only
 component that knows how many Islands and Ships there are, but it does not
 know about any of their derived classes, nor which Ships are of what kind of Ship. 
 It has facilities for looking up objects by name, and removing Ships.  When
-created, it creates an initial group of Islands and Ships using the Ship_factory.
+created, it creates an initial group of Islands and Ships from a built-in scenario.
 Finally, it keeps the system's time.
 
 Controller tells Model what to do; Model in turn tells the objects what do, and
@@ -34,66 +50,173 @@ public:
 	typedef std::shared_ptr<Sim_object> Sim_object_ptr;
 
 	typedef std::map<std::string, Island_ptr> Island_map;
+	typedef std::map<std::string, Ship_ptr> Ship_map;
 
 	static Model* get_Instance();
 
 	// return the current time
 	int get_time() {return time;}
 
+	/* Name interning - each name is given a dense integer ID, which is used in place of
+	the name in the notifications to the Views, so that they can keep their information
+	in arrays indexed by ID. A name always gets the same ID, and IDs are never reused. */
+	// return the ID of the name, assigning the next unused one if it has none yet
+	static int intern_name(const std::string& name);
+	static const std::string& get_name_of_id(int id)
+		{return id_names[id];}
+	// return every assigned ID, ordered by the names
+	static const std::vector<int>& get_ids_in_name_order();
+
 	// is name already in use for either ship or island?
     // either the identical name, or identical in first two characters counts as in-use
 	bool is_name_in_use(const std::string& name) const
     {
-        return objects.find(name) != objects.end();
+        return name_index.find(name) != nullptr;
     }
 
 	// is there such an island?
 	bool is_island_present(const std::string& name) const
     {
-        return islands.find(name) != islands.end();
+        return island_index.find(name) != nullptr;
     }
 	// will throw Error("Island not found!") if no island of that name
 	Island_ptr get_island_ptr(const std::string& name) const;
-	// returns a vector of ptrs to every island
-	Island_map get_islands() const
+	// add a new island to the lists, and update the view
+	void add_island(Island_ptr island);
+	// returns the map of every island, in name order
+	const Island_map& get_islands() const
 	{
 		return islands;
 	};
+	// return the registry of the current islands; the same one is shared until the islands change
+	std::shared_ptr<const Island_registry> get_island_registry() const;
+	// the version of the registry of the current islands, which goes up when they change
+	int get_island_version() const
+		{return island_version;}
 
 	// is there such an ship?
 	bool is_ship_present(const std::string& name) const
     {
-        return ships.find(name) != ships.end();
+        return ship_index.find(name) != nullptr;
     }
 	// add a new ship to the list, and update the view
 	void add_ship(Ship_ptr);
+	// returns the map of every ship, in name order
+	const Ship_map& get_ships() const
+	{
+		return ships;
+	}
 	// will throw Error("Ship not found!") if no ship of that name
 	Ship_ptr get_ship_ptr(const std::string& name) const;
+	// the ship is not updated again, and is taken out of the containers, with the
+	// Views told that it is gone, together with any others at the end of the tick
+	// will throw Error("Ship not found!") if there is no such ship
 	void remove_ship(Ship_ptr ship);
+
+	/* Proximity queries - these use a spatial index instead of examining every object;
+	during run_until, the ships are brought up to date first */
+	// return the island nearest to location whose name is accepted by the supplied function,
+	// or an empty pointer if there is none; of equally near islands, the first by name is returned
+	Island_ptr find_nearest_island(Point location, const std::function<bool(const std::string&)>& accept) const;
+	// return the ships whose distance from location is less than or equal to radius, in no particular order
+	std::vector<Ship_ptr> find_ships_in_radius(Point location, double radius);
+	// return up to k ships that are accepted by the supplied function, nearest to location first;
+	// ships farther from location than max_distance are not looked at
+	std::vector<Ship_ptr> find_nearest_ships(Point location, int k, const std::function<bool(const Ship&)>& accept,
+			double max_distance = std::numeric_limits<double>::infinity());
 	
 	// tell all objects to describe themselves
 	void describe() const;
-	// increment the time, and tell all objects to update themselves
+	// increment the time, and tell all objects to update themselves;
+	// their messages are discarded in quiet mode
 	void update();
+
+	// advance the time to end_time, jumping over the hours in which no object
+	// does more than steady progress; only objects with an event are updated
+	// (and produce output). The others are brought up to date quietly when another
+	// object reads or changes them, and all of them by the time this returns.
+	// will throw Error("Time must not be earlier than the current time!")
+	void run_until(int end_time);
+	// during run_until, make the steady progress the object would have made by now
+	// in this hour; call before reading or changing the state of another object
+	void bring_up_to_date(Sim_object& object);
+	// an object's state was changed by another object, so recompute its next event
+	void reschedule(const std::string& name);
+
+	/* Collision risk monitoring - after each update, every pair of ships of which at least
+	one is moving is screened for a closest point of approach less than the risk range
+	within the risk horizon. Only ships near enough to reach that range in that time are
+	examined, using the spatial index. run_until screens the ships once, when it is done:
+	nothing shows the risks before then, so those of each hour would only be replaced by
+	the next, and screening would need every ship brought up to date in every hour. */
+	// return the risks found at the last update, ordered by the names of the first
+	// and then the second ship of each pair; the first name is less than the second
+	const std::vector<Collision_risk>& get_collision_risks() const
+		{return collision_risks;}
+	// set the risk range, in nm, and the horizon, in hours, and screen the ships again
+	// will throw Error("Collision risk range and horizon must be positive!")
+	void set_collision_risk_limits(double range, double horizon);
+	double get_collision_risk_range() const
+		{return collision_risk_range;}
+	double get_collision_risk_horizon() const
+		{return collision_risk_horizon;}
+
+	/* Scenarios - a scenario file describes a world to start from, one object per line:
+		island <name> <x> <y> <fuel> <production rate>
+		ship <name> <type> <x> <y>
+	A line starting with # is a comment. The objects are added all at once, building
+	the containers in one pass and telling the Views about them only at the end. */
+	// replace the current objects with those of the scenario, and start the time again;
+	// the file is checked before the current objects are discarded
+	// will throw Error("Could not open scenario file!") if the file cannot be read, or
+	// Error("Invalid scenario file!") if a line is malformed, a number is not finite,
+	// or a name is in use twice
+	void load_scenario(const std::string& filename);
+
+	/* Snapshots - the whole state of the simulation can be saved to a file and loaded
+	from it later, replacing the current objects; see Snapshot.h for the format. */
+	// will throw Error("Could not write snapshot file!") if the file cannot be written
+	void save(const std::string& filename) const;
+	// the current objects are discarded only once every object of the snapshot has been
+	// restored, so a file that is not a complete snapshot leaves the simulation as it was
+	// will throw an Error from Snapshot_reader if the file cannot be read or is not a snapshot,
+	// or Error("Invalid snapshot file!") if an object refers to one that is not in it
+	void load(const std::string& filename);
+
+	// use the supplied number of threads for the movement of ships in update;
+	// one thread means no parallel work. Output is the same for any number.
+	// will throw Error("Thread count must be positive!") if count is less than one
+	void set_thread_count(int count);
     
 	/* View services */
+	// The Views are not told about changes as they happen. Instead, the latest notified
+	// state of each object is kept here with a count of when each part of it last changed,
+	// and a View is brought up to date with just the changes since its last refresh when
+	// it is about to be drawn. Views that are not drawn cost nothing as the objects change,
+	// and a refresh goes through only the objects changed since the last one.
+
 	// Attaching a View adds it to the container and causes it to be updated
     // with all current objects' locations (or other state information).
 	void attach(std::shared_ptr<View>);
 	// Detach the View by discarding the supplied pointer from the container of Views
     // - no updates sent to it thereafter.
 	void detach(std::shared_ptr<View>);
+	// send the attached View the changes made since it was last refreshed,
+	// in the same form as they were notified; call before drawing it. A View that is
+	// refreshed at the end of every tick is refreshed by the Model itself, and while one
+	// is attached, run_until processes every hour instead of jumping over them.
+	void refresh_view(std::shared_ptr<View>);
 
 	// notify the views about a ship's location
-	void notify_location_ship(const std::string &name, Point location);
+	void notify_location_ship(int id, Point location);
 	// notify the views about a island's location
-	void notify_location_island(const std::string &name, Point location);
+	void notify_location_island(int id, Point location);
 	// notify the views that an object is now gone
-	void notify_gone(const std::string& name);
+	void notify_gone(int id);
 	// notify the views that a ship has changed fuel
-	void notify_fuel(const std::string& name, double fuel);
+	void notify_fuel(int id, double fuel);
 	// notify the views that a ship has changed course and speed
-	void notify_course_speed(const std::string& name, double course, double speed);
+	void notify_course_speed(int id, double course, double speed);
 
 	// disallow copy/move construction or assignment
 	Model(const Model&) = delete;
@@ -109,21 +232,141 @@ private:
 
 	int time;		// the simulated time
 
-	typedef std::map<std::string, Ship_ptr> Ship_map;
+	// the name of each ID, the ID of each name, and the IDs in name order
+	static std::vector<std::string> id_names;
+	static std::map<std::string, int> name_ids;
+	static std::vector<int> ids_by_name;
+	static std::vector<int> unordered_ids;	// assigned but not yet put into ids_by_name
+	std::unique_ptr<Worker_pool> workers;	// null if update is single-threaded
+
+	// the times of the next events of the objects during run_until; a queue entry
+	// is current only if its time matches the time in event_times for its name
+	typedef std::pair<int, std::string> Event;
+	std::priority_queue<Event, std::vector<Event>, std::greater<Event>> event_queue;
+	std::map<std::string, int> event_times;
+	bool running_events;
+	// during an hour of run_until, the objects to be updated, and the name of the
+	// object being processed; objects after it have not been processed yet
+	std::set<std::string> due_objects;
+	std::string event_cursor;
+	// during run_until, the time up to which each object has been advanced, indexed by object ID
+	std::vector<int> advanced_times;
+
+	// put the object's next event into the queue, if it has one
+	void schedule_event(Sim_object_ptr object);
+	// make the steady progress of the object up to target_time, if it is not there yet
+	void advance_to(Sim_object& object, int target_time);
+	// during run_until, bring every ship up to date
+	void bring_ships_up_to_date();
+	// finish run_until, bringing every object up to the current time
+	void end_events();
+	// decide for every attacking Warship whether its target will be in range in the coming tick
+	void resolve_ranges();
+
+	std::vector<Collision_risk> collision_risks;
+	unsigned long collision_risks_change;	// the change count when they were last found
+	double collision_risk_range;
+	double collision_risk_horizon;
+
+	// find the collision risks for the current state of the ships
+	void find_collision_risks();
+
+	// the ships to be removed at the end of the tick, and whether each object ID is one of them
+	std::vector<Ship_ptr> removed_ships;
+	std::vector<bool> removal_pending;
+
+	bool is_removal_pending(int id) const
+		{return id < int(removal_pending.size()) && removal_pending[id];}
+	// take the removed ships out of the containers and indexes all at once
+	void remove_pending_ships();
+
+	// discard every object, telling the Views that they are gone
+	void clear_objects();
+	// replace the current objects with those of the scenario being scanned
+	void add_scenario(Command_file& scenario);
+
 	struct title_substring_compare
 	{
 		bool operator()(const std::string& first, const std::string& second) const
 		{
-			return first.substr(0, SHORTEN_NAME_LENGTH) < second.substr(0, SHORTEN_NAME_LENGTH);
+			return first.compare(0, SHORTEN_NAME_LENGTH, second, 0, SHORTEN_NAME_LENGTH) < 0;
 		}
 	};
 	typedef std::map<std::string, Sim_object_ptr, title_substring_compare> Sim_object_map;
 
+	// the objects in name order, for going through them in a fixed order
     Island_map islands;
 	Ship_map ships;
 	Sim_object_map objects;
+	// the same objects, for looking them up by name; name_index holds every object
+	// under the leading characters of its name, which must be unique
+	Name_table<Island_ptr> island_index;
+	Name_table<Ship_ptr> ship_index;
+	Name_table<Sim_object_ptr> name_index;
+	// the ships again, indexed by object ID, for the entries of ship_grid; empty where there is none
+	std::vector<Ship_ptr> ships_by_id;
+
+	int island_version;
+	mutable std::shared_ptr<const Island_registry> island_registry;	// made when first asked for
+
+	// add the object to the containers and indexes
+	void insert_island(Island_ptr island);
+	void insert_ship(Ship_ptr ship);
+	// make the ship the one found for its ID
+	void index_ship_by_id(Ship_ptr ship);
+
+	// the containers and indexes of a set of objects, for setting the current ones aside
+	struct Object_containers {
+		Object_containers();
+		Island_map islands;
+		Ship_map ships;
+		Sim_object_map objects;
+		Name_table<Island_ptr> island_index;
+		Name_table<Ship_ptr> ship_index;
+		Name_table<Sim_object_ptr> name_index;
+		std::vector<Ship_ptr> ships_by_id;
+		Spatial_grid island_grid;
+		Spatial_grid ship_grid;
+	};
+	// exchange the current objects with the supplied ones, without telling the Views
+	void swap_objects(Object_containers& other);
+
+	// spatial indexes of the locations of the islands and ships
+	Spatial_grid island_grid;
+	Spatial_grid ship_grid;
+
+	// the latest notified state of an object, and the change counts at which each part
+	// was last notified; a count of zero means that part has never been notified
+	struct Notified_state {
+		Point location;
+		bool is_island = false;
+		double course = 0., speed = 0.;
+		double fuel = 0.;
+		Point gone_location;	// the location when the object was last gone
+		unsigned long location_change = 0, course_speed_change = 0, fuel_change = 0, gone_change = 0;
+		unsigned long latest_change = 0;	// the latest of the counts of the parts
+		int older_id = -1, newer_id = -1;	// the neighbours in the list of changed objects
+	};
+	std::vector<Notified_state> notified_states;	// indexed by object ID
+	unsigned long change_count;		// the count of the latest change
+	// the changed objects are linked in the order of their latest change; the newest one
+	int newest_changed_id;
+
+	// return the notified state of the object, making room for it if needed,
+	// count a new change, and make the object the newest changed one
+	Notified_state& record_change(int id);
+
+	// each View with the change count up to which it has been refreshed
+	struct View_record {
+		std::shared_ptr<View> view;
+		unsigned long refreshed_change;
+	};
+	std::vector<View_record> views;
 
-    std::vector<std::shared_ptr<View>> views;
+	// is any attached View refreshed at the end of every tick?
+	bool has_tick_views() const;
+	// refresh those Views, and tell them that the tick has ended
+	void refresh_tick_views();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,126 @@
+#ifndef NAME_TABLE_H
+#define NAME_TABLE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+/* Name_table
+A Name_table is a hash table from names to values, for looking up objects by name
+without the string comparisons of a tree, and without allocating on a lookup. Its
+key is the leading key_length characters of a name (all of them by default), so
+that names that are the same in those characters are the same key. It uses open
+addressing with linear probing in a single array of slots, which is kept at most
+half full; removal moves later entries of a probe sequence back instead of leaving
+markers. The order of the entries is unspecified, so it is used alongside ordered
+containers where the order of the objects matters.
+*/
+
+template<typename T>
+class Name_table {
+public:
+    explicit Name_table(std::size_t key_length_ = std::string::npos) :
+        key_length(key_length_), count(0)
+    {}
+
+    // return a pointer to the value whose key the name has, or null if there is none
+    T* find(const std::string& name)
+    {
+        if (slots.empty()) return nullptr;
+        Slot& slot = slots[find_slot(name)];
+        return slot.used ? &slot.value : nullptr;
+    }
+    const T* find(const std::string& name) const
+        {return const_cast<Name_table*>(this)->find(name);}
+
+    // add the value under the name's key; return false, adding nothing, if the key is present
+    bool insert(const std::string& name, const T& value)
+    {
+        if (2 * (count + 1) > slots.size()) grow();
+        Slot& slot = slots[find_slot(name)];
+        if (slot.used) return false;
+        slot.name = name;
+        slot.value = value;
+        slot.used = true;
+        ++count;
+        return true;
+    }
+
+    // remove the value under the name's key; return false if there is none
+    bool erase(const std::string& name)
+    {
+        if (slots.empty()) return false;
+        std::size_t hole = find_slot(name);
+        if (!slots[hole].used) return false;
+        // move back each later entry of the run whose home slot is not between the hole and it
+        std::size_t mask = slots.size() - 1;
+        for (std::size_t next = (hole + 1) & mask; slots[next].used; next = (next + 1) & mask)
+        {
+            std::size_t home = hash(slots[next].name) & mask;
+            if (((next - home) & mask) >= ((next - hole) & mask))
+            {
+                std::swap(slots[hole], slots[next]);
+                hole = next;
+            }
+        }
+        slots[hole] = Slot();
+        --count;
+        return true;
+    }
+
+    void clear()
+    {
+        slots.clear();
+        count = 0;
+    }
+
+    std::size_t size() const
+        {return count;}
+
+private:
+    struct Slot {
+        std::string name;
+        T value;
+        bool used = false;
+    };
+    std::vector<Slot> slots;    // the number is zero or a power of two
+    std::size_t key_length;
+    std::size_t count;
+
+    // FNV-1a over the characters of the key
+    std::size_t hash(const std::string& name) const
+    {
+        std::size_t length = name.size() < key_length ? name.size() : key_length;
+        std::size_t result = 14695981039346656037ULL;
+        for (std::size_t i = 0; i < length; i++)
+        {
+            result ^= static_cast<unsigned char>(name[i]);
+            result *= 1099511628211ULL;
+        }
+        return result;
+    }
+    // return the slot holding the name's key, or the empty slot where it would go
+    std::size_t find_slot(const std::string& name) const
+    {
+        std::size_t mask = slots.size() - 1;
+        std::size_t index = hash(name) & mask;
+        while (slots[index].used && slots[index].name.compare(0, key_length, name, 0, key_length) != 0)
+        {
+            index = (index + 1) & mask;
+        }
+        return index;
+    }
+    // double the number of slots, and put the entries in their new places
+    void grow()
+    {
+        std::vector<Slot> old_slots(slots.size() ? 2 * slots.size() : 8);
+        old_slots.swap(slots);
+        for (auto&& slot : old_slots)
+        {
+            if (slot.used) std::swap(slots[find_slot(slot.name)], slot);
+        }
+    }
+};
+
+#endif
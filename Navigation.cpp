@@ -9,6 +9,9 @@ See Navigation.h for comments
 #include <iostream>
 #include <cmath>
 #include <cassert>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -219,5 +222,70 @@ Compass_position compute_CPA(Course_speed ownship_cs, Course_speed target_cs, Co
 		}
 }
 
+// *** compute_CPA_batch ***
+// Compute the closest points of approach of many targets to ownship at once.
+// Each target is handled as in compute_CPA, but with the vectors in Cartesian form throughout:
+// t is the parameter along the relative motion line of the closest point; if it is positive,
+// the closest point was the initial point, otherwise the time to it is -t.
 
+void compute_CPA_batch(Point ownship_position, Course_speed ownship_cs, int count,
+	const double* target_x, const double* target_y, const double* target_velocity_x, const double* target_velocity_y,
+	double* CPA_range, double* CPA_bearing, double* time_to_CPA)
+{
+	Cartesian_vector ownship_cv = compass_unit_vector(ownship_cs.course) * ownship_cs.speed;
+	int i = 0;
+#ifdef __AVX2__
+	// four targets at a time
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d ownship_x = _mm256_set1_pd(ownship_position.x);
+	const __m256d ownship_y = _mm256_set1_pd(ownship_position.y);
+	const __m256d ownship_vx = _mm256_set1_pd(ownship_cv.delta_x);
+	const __m256d ownship_vy = _mm256_set1_pd(ownship_cv.delta_y);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256d position_x = _mm256_sub_pd(_mm256_loadu_pd(target_x + i), ownship_x);
+		__m256d position_y = _mm256_sub_pd(_mm256_loadu_pd(target_y + i), ownship_y);
+		__m256d motion_x = _mm256_sub_pd(_mm256_loadu_pd(target_velocity_x + i), ownship_vx);
+		__m256d motion_y = _mm256_sub_pd(_mm256_loadu_pd(target_velocity_y + i), ownship_vy);
+		__m256d numerator = _mm256_add_pd(_mm256_mul_pd(motion_x, position_x), _mm256_mul_pd(motion_y, position_y));
+		__m256d denominator = _mm256_add_pd(_mm256_mul_pd(motion_x, motion_x), _mm256_mul_pd(motion_y, motion_y));
+		__m256d t = _mm256_div_pd(numerator, denominator);
+		// no relative motion means the closest point is the initial point
+		t = _mm256_blendv_pd(t, zero, _mm256_cmp_pd(denominator, zero, _CMP_EQ_OQ));
+		__m256d time = _mm256_sub_pd(zero, _mm256_min_pd(t, zero));
+		__m256d CPA_x = _mm256_add_pd(position_x, _mm256_mul_pd(time, motion_x));
+		__m256d CPA_y = _mm256_add_pd(position_y, _mm256_mul_pd(time, motion_y));
+		_mm256_storeu_pd(CPA_range + i, _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(CPA_x, CPA_x), _mm256_mul_pd(CPA_y, CPA_y))));
+		_mm256_storeu_pd(time_to_CPA + i, time);
+	}
+#endif
+	// the remaining targets, or all of them without AVX2
+	for (; i < count; i++)
+	{
+		double position_x = target_x[i] - ownship_position.x;
+		double position_y = target_y[i] - ownship_position.y;
+		double motion_x = target_velocity_x[i] - ownship_cv.delta_x;
+		double motion_y = target_velocity_y[i] - ownship_cv.delta_y;
+		double denominator = motion_x * motion_x + motion_y * motion_y;
+		double t = denominator == 0. ? 0. : (motion_x * position_x + motion_y * position_y) / denominator;
+		double time = t > 0. ? 0. : 0. - t;
+		double CPA_x = position_x + time * motion_x;
+		double CPA_y = position_y + time * motion_y;
+		CPA_range[i] = sqrt(CPA_x * CPA_x + CPA_y * CPA_y);
+		time_to_CPA[i] = time;
+	}
+	if (!CPA_bearing) return;
+	for (i = 0; i < count; i++)
+	{
+		Cartesian_vector CPA_position(target_x[i] - ownship_position.x + time_to_CPA[i] * (target_velocity_x[i] - ownship_cv.delta_x),
+			target_y[i] - ownship_position.y + time_to_CPA[i] * (target_velocity_y[i] - ownship_cv.delta_y));
+		CPA_bearing[i] = Compass_position(Polar_vector(CPA_position)).bearing;
+	}
+}
 
+// *** compass_unit_vector ***
+// Return the Cartesian vector of unit length in the direction of a compass course.
+Cartesian_vector compass_unit_vector(double course)
+{
+	return Cartesian_vector(Polar_vector(1., to_radians(to_other_degrees(course))));
+}
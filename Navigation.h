@@ -64,6 +64,7 @@ the Compass_vector for its course and the time to get its new Point:
 
 // forward declarations
 struct Point;
+struct Cartesian_vector;
 struct Polar_vector;
 struct Course_speed;
 struct Compass_position;
@@ -148,5 +149,23 @@ std::ostream& operator<< (std::ostream& os, const Compass_vector& cv);
 // If the CPA is the current position, it is returned with the time being zero.
 Compass_position compute_CPA(Course_speed ownship_cs, Course_speed target_cs, Compass_position target_position_cp, double& time_to_CPA);
 
+// Compute the closest points of approach of many targets to ownship at once, for screening
+// every neighbour of a ship. The targets are given in packed arrays of their positions
+// and of their velocities as Cartesian vectors in nm/hr (a unit vector of the course times the speed).
+// For each target i, CPA_range[i], CPA_bearing[i], and time_to_CPA[i] receive the results that
+// compute_CPA would give, to within rounding. If the target has no motion relative to ownship,
+// its CPA is its current position. CPA_bearing may be null if the bearings are not needed;
+// they are the only part not vectorized. The computation uses AVX2 instructions when compiled
+// for a processor that has them (e.g. with -mavx2), and otherwise plain scalar code.
+void compute_CPA_batch(Point ownship_position, Course_speed ownship_cs, int count,
+	const double* target_x, const double* target_y, const double* target_velocity_x, const double* target_velocity_y,
+	double* CPA_range, double* CPA_bearing, double* time_to_CPA);
+
+// Return the Cartesian vector of unit length in the direction of a compass course.
+// Multiplying it by a distance gives exactly the same displacement as adding a
+// Compass_vector of that course and distance to a Point, but without the trigonometry,
+// so it can be computed once when a course is set and reused at every move.
+Cartesian_vector compass_unit_vector(double course);
+
 
 #endif
@@ -0,0 +1,46 @@
+#include "Output.h"
+#include <iostream>
+
+using namespace std;
+
+const int OUTPUT_BUFFER_SIZE = 1 << 20;
+
+static char output_buffer[OUTPUT_BUFFER_SIZE];
+static bool quiet_mode = false;
+
+// give cout a large buffer and untie it from cin; must be called before any input or output
+void init_output()
+{
+    ios::sync_with_stdio(false);
+    cout.rdbuf()->pubsetbuf(output_buffer, OUTPUT_BUFFER_SIZE);
+    cin.tie(nullptr);
+}
+
+// send all buffered output to the terminal
+void flush_output()
+{
+    cout.flush();
+}
+
+// turn quiet mode on or off
+void set_quiet_mode(bool quiet)
+{
+    quiet_mode = quiet;
+}
+
+bool is_quiet_mode()
+{
+    return quiet_mode;
+}
+
+// discard output to cout if quiet mode is on
+Quiet_output_guard::Quiet_output_guard() : discarding(quiet_mode && cout.good())
+{
+    if (discarding) cout.setstate(ios::badbit);
+}
+
+// restore output to cout
+Quiet_output_guard::~Quiet_output_guard()
+{
+    if (discarding) cout.clear();
+}
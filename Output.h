@@ -0,0 +1,41 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+/* Output services
+All output goes to cout, which is given a large buffer and is no longer flushed
+at every line or every read from cin; instead it is flushed explicitly whenever
+the user is asked for a command, after each command of a batch file, and before
+anything that may stop the program with a failed assertion, so that the output
+leading up to it is not lost.
+
+In quiet mode, the messages that objects output while the Model is updating them are
+discarded. While a Quiet_output_guard exists and quiet mode is on, cout is put into a
+failed state, so output operations return at once without formatting anything.
+*/
+
+// give cout a large buffer and untie it from cin; must be called before any input or output
+void init_output();
+
+// send all buffered output to the terminal
+void flush_output();
+
+// turn quiet mode on or off
+void set_quiet_mode(bool quiet);
+bool is_quiet_mode();
+
+class Quiet_output_guard {
+public:
+    // discard output to cout if quiet mode is on
+    Quiet_output_guard();
+    // restore output to cout
+    ~Quiet_output_guard();
+
+    // disallow copy/move construction or assignment
+    Quiet_output_guard(const Quiet_output_guard&) = delete;
+    Quiet_output_guard& operator=(const Quiet_output_guard&) = delete;
+
+private:
+    bool discarding;
+};
+
+#endif
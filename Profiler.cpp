@@ -0,0 +1,168 @@
+#include "Profiler.h"
+#include "Utility.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <vector>
+
+using namespace std;
+
+#ifdef PROFILING
+
+// the number of the most recent ticks whose totals are kept
+const int PROFILE_HISTORY_TICKS = 4096;
+
+const char* const profile_section_names[PROFILE_SECTION_COUNT] = {
+    "Model::update",
+    "Island::update",
+    "Tanker::update",
+    "Cruiser::update",
+    "Cruise_ship::update",
+    "Model::resolve_ranges",
+    "Model::notify",
+    "Model::refresh_view",
+    "View_map::draw",
+    "View_sail::draw",
+    "View_bridge::draw"
+};
+
+// count every heap allocation, from any thread
+static atomic<long> allocation_count(0);
+
+void* operator new(size_t size)
+{
+    allocation_count.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+long get_allocation_count()
+{
+    return allocation_count.load(memory_order_relaxed);
+}
+
+struct Section_totals {
+    long calls = 0;
+    long long nanoseconds = 0;
+    long allocations = 0;
+};
+
+// the totals of the tick in progress, and those of the recorded ticks, oldest first once
+// the history is full; first_tick is the number of the oldest recorded tick
+static Section_totals current_totals[PROFILE_SECTION_COUNT];
+static deque<vector<Section_totals>> tick_history;
+static long first_tick = 0;
+
+static long long nanoseconds_now()
+{
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Profile_scope::Profile_scope(Profile_section section_, bool ends_tick_) :
+    section(section_), ends_tick(ends_tick_), start_nanoseconds(nanoseconds_now()), start_allocations(get_allocation_count())
+{
+}
+
+Profile_scope::~Profile_scope()
+{
+    Section_totals& totals = current_totals[section];
+    ++totals.calls;
+    totals.nanoseconds += nanoseconds_now() - start_nanoseconds;
+    totals.allocations += get_allocation_count() - start_allocations;
+    if (!ends_tick) return;
+    // keep the totals of the tick
+    if (int(tick_history.size()) == PROFILE_HISTORY_TICKS)
+    {
+        tick_history.pop_front();
+        ++first_tick;
+    }
+    tick_history.emplace_back(current_totals, current_totals + PROFILE_SECTION_COUNT);
+    fill(current_totals, current_totals + PROFILE_SECTION_COUNT, Section_totals());
+}
+
+// return the value at the fraction of the way through the sorted values
+template<typename T>
+static T percentile(const vector<T>& sorted_values, double fraction)
+{
+    return sorted_values[int(fraction * (sorted_values.size() - 1) + .5)];
+}
+
+// output the number of ticks recorded and, for each section, the median and 99th
+// percentile of its calls, time and allocations per tick, over the ticks it was entered in
+void print_profile_stats()
+{
+    cout << "Profile of " << tick_history.size() << " ticks, per tick in which each section was entered" << '\n';
+    cout << setw(20) << left << "Section" << right << setw(7) << "Ticks" << setw(10) << "Calls p50"
+            << setw(10) << "p99" << setw(12) << "Time us p50" << setw(10) << "p99"
+            << setw(11) << "Allocs p50" << setw(10) << "p99" << '\n';
+    vector<long> calls, allocations;
+    vector<long long> nanoseconds;
+    for (int section = 0; section < PROFILE_SECTION_COUNT; section++)
+    {
+        calls.clear();
+        nanoseconds.clear();
+        allocations.clear();
+        for (auto&& tick : tick_history)
+        {
+            if (!tick[section].calls) continue;
+            calls.push_back(tick[section].calls);
+            nanoseconds.push_back(tick[section].nanoseconds);
+            allocations.push_back(tick[section].allocations);
+        }
+        if (calls.empty()) continue;
+        sort(calls.begin(), calls.end());
+        sort(nanoseconds.begin(), nanoseconds.end());
+        sort(allocations.begin(), allocations.end());
+        cout << setw(20) << left << profile_section_names[section] << right << setw(7) << calls.size()
+                << setw(10) << percentile(calls, .5) << setw(10) << percentile(calls, .99)
+                << setw(12) << percentile(nanoseconds, .5) / 1000. << setw(10) << percentile(nanoseconds, .99) / 1000.
+                << setw(11) << percentile(allocations, .5) << setw(10) << percentile(allocations, .99) << '\n';
+    }
+}
+
+// write the totals of each section in each recorded tick to a CSV file
+void export_profile_stats(const string& filename)
+{
+    ofstream file(filename);
+    if (!file) throw Error("Could not write statistics file!");
+    file << "tick,section,calls,nanoseconds,allocations\n";
+    long tick_number = first_tick;
+    for (auto&& tick : tick_history)
+    {
+        for (int section = 0; section < PROFILE_SECTION_COUNT; section++)
+        {
+            const Section_totals& totals = tick[section];
+            if (!totals.calls) continue;
+            file << tick_number << ',' << profile_section_names[section] << ',' << totals.calls << ','
+                    << totals.nanoseconds << ',' << totals.allocations << '\n';
+        }
+        ++tick_number;
+    }
+    if (!file) throw Error("Could not write statistics file!");
+}
+
+#else
+
+const char* const PROFILING_NOT_COMPILED_MSG = "Profiling is not compiled into this build!";
+
+void print_profile_stats()
+{
+    throw Error(PROFILING_NOT_COMPILED_MSG);
+}
+
+void export_profile_stats(const string&)
+{
+    throw Error(PROFILING_NOT_COMPILED_MSG);
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+
+/* Profiling
+The profiler records, for each section of the program it watches, how much wall time
+was spent in it, how many times it was entered, and how many heap allocations were
+made in it. The totals are collected for each tick - an hour processed by the Model -
+and the totals of the most recent ticks are kept, so that their distribution can be
+shown as percentiles or exported as a CSV file with one line per section and tick.
+Sections are timed inclusively; Model::update, which also covers each hour processed
+by Model::run_until, contains the updates of the objects.
+Drawing happens between ticks, so it counts toward the tick that follows it.
+
+Profiling is compiled in unless NDEBUG is defined, as it is for a release build. Then
+PROFILE_SCOPE expands to nothing, no counters exist, and operator new is not replaced.
+*/
+
+#ifndef NDEBUG
+#define PROFILING
+#endif
+
+enum Profile_section {
+    PROFILE_MODEL_UPDATE,
+    PROFILE_ISLAND_UPDATE,
+    PROFILE_TANKER_UPDATE,
+    PROFILE_CRUISER_UPDATE,
+    PROFILE_CRUISE_SHIP_UPDATE,
+    PROFILE_COMBAT_RESOLVE,
+    PROFILE_MODEL_NOTIFY,
+    PROFILE_MODEL_REFRESH_VIEW,
+    PROFILE_MAP_DRAW,
+    PROFILE_SAIL_DRAW,
+    PROFILE_BRIDGE_DRAW,
+    PROFILE_SECTION_COUNT
+};
+
+#ifdef PROFILING
+
+// a Profile_scope adds the time and allocations from its construction to its
+// destruction, and one call, to the section's totals for the current tick;
+// if it ends the tick, the tick is ended after that
+class Profile_scope {
+public:
+    explicit Profile_scope(Profile_section section_, bool ends_tick_ = false);
+    ~Profile_scope();
+
+    // disallow copy/move construction or assignment
+    Profile_scope(const Profile_scope&) = delete;
+    Profile_scope& operator=(const Profile_scope&) = delete;
+
+private:
+    Profile_section section;
+    bool ends_tick;
+    long long start_nanoseconds;
+    long start_allocations;
+};
+
+#define PROFILE_SCOPE(section) Profile_scope profile_scope(section)
+// profile the processing of one tick by the Model, and end the tick
+#define PROFILE_TICK() Profile_scope profile_scope(PROFILE_MODEL_UPDATE, true)
+
+// return the number of heap allocations made so far by the program
+long get_allocation_count();
+
+#else
+
+#define PROFILE_SCOPE(section)
+#define PROFILE_TICK()
+
+#endif
+
+// output the number of ticks recorded and, for each section, the median and 99th
+// percentile of its calls, time and allocations per tick, over the ticks it was entered in
+// will throw Error("Profiling is not compiled into this build!") if it is not
+void print_profile_stats();
+
+// write the totals of each section in each recorded tick to a CSV file
+// will throw Error("Profiling is not compiled into this build!") if it is not, or
+// Error("Could not write statistics file!") if the file cannot be written
+void export_profile_stats(const std::string& filename);
+
+#endif
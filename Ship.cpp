@@ -1,5 +1,7 @@
 #include "Ship.h"
 #include "Island.h"
+#include "Navigation.h"
+#include "Snapshot.h"
 #include <sstream>
 #include <iostream>
 #include <cassert>
@@ -11,11 +13,10 @@ const double SHIP_DOCK_DISTANCE = .1;
 
 Ship::Ship(const string &name_, Point position_, double fuel_capacity_,
         double maximum_speed_, double fuel_consumption_, int resistance_) :
-        Sim_object(name_), fuel(fuel_capacity_), fuel_consumption(fuel_consumption_),
-		fuel_capacity(fuel_capacity_), track(position_, Course_speed(0, 0)), max_speed(maximum_speed_),
-		resistance(resistance_), ship_state(State_ship::STOPPED)
+        Sim_object(name_), slot(store().allocate(position_, fuel_capacity_, fuel_consumption_)),
+		fuel_capacity(fuel_capacity_), max_speed(maximum_speed_), resistance(resistance_)
 {
-	if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Ship " << get_name() << " constructed" << endl;
+	if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Ship " << get_name() << " constructed" << '\n';
 }
 
 /*
@@ -28,7 +29,8 @@ are defining it just to get the destructor message output.
 
 Ship::~Ship()
 {
-	if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Ship "  << get_name() << " destructed" << endl;
+	store().release(slot);
+	if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Ship "  << get_name() << " destructed" << '\n';
 }
 
 // Return true if the ship is Stopped and the distance to the supplied island
@@ -36,31 +38,31 @@ Ship::~Ship()
 bool Ship::can_dock(shared_ptr<Island> island_ptr) const
 {
 	assert(island_ptr);
-	return ship_state == State_ship::STOPPED && cartesian_distance(get_location(), island_ptr->get_location()) <= SHIP_DOCK_DISTANCE;
+	return get_state() == State_ship::STOPPED && cartesian_distance(get_location(), island_ptr->get_location()) <= SHIP_DOCK_DISTANCE;
 }
 
 /*** Interface to derived classes ***/
 // Update the state of the Ship
 void Ship::update()
 {
-	switch(ship_state)
+	switch(get_state())
 	{
 		case State_ship::SUNK:
-			cout << get_name() << " sunk" << endl;
+			cout << get_name() << " sunk" << '\n';
 			break;
 		case State_ship::MOVING_ON_COURSE:
 		case State_ship::MOVING_TO_POSITION:
 			calculate_movement();
-			cout << get_name() << " now at " << get_location() << endl;
+			cout << get_name() << " now at " << get_location() << '\n';
 			break;
 		case State_ship::STOPPED:
-			cout << get_name() << " stopped at " << get_location() << endl;
+			cout << get_name() << " stopped at " << get_location() << '\n';
 			break;
 		case State_ship::DOCKED:
-			cout << get_name() << " docked at " << get_docked_Island()->get_name() << endl;
+			cout << get_name() << " docked at " << get_docked_Island()->get_name() << '\n';
 			break;
 		case State_ship::DEAD_IN_THE_WATER:
-			cout << get_name() << " dead in the water at " << get_location() << endl;
+			cout << get_name() << " dead in the water at " << get_location() << '\n';
 			break;
 	}
 }
@@ -69,35 +71,35 @@ void Ship::update()
 void Ship::describe() const
 {
 	cout << get_name() << " at " << get_location();
-	switch(ship_state)
+	switch(get_state())
 	{
 		case State_ship::SUNK:
-			cout << " sunk" << endl;
+			cout << " sunk" << '\n';
 			return;
 		default:
-			cout << ", fuel: " << fuel << " tons, resistance: " << resistance << endl;
+			cout << ", fuel: " << get_fuel() << " tons, resistance: " << resistance << '\n';
 			break;
 	}
-	switch(ship_state)
+	switch(get_state())
 	{
 		case State_ship::MOVING_TO_POSITION:
-			cout << "Moving to " << destination << " on ";
+			cout << "Moving to " << store().get_destination(slot) << " on ";
 			print_course_and_speed();
-			cout << endl;
+			cout << '\n';
 			break;
 		case State_ship::MOVING_ON_COURSE:
 			cout << "Moving on ";
 			print_course_and_speed();
-			cout << endl;
+			cout << '\n';
 			break;
 		case State_ship::DOCKED:
-			cout << "Docked at " << get_docked_Island()->get_name() << endl;
+			cout << "Docked at " << get_docked_Island()->get_name() << '\n';
 			break;
 		case State_ship::STOPPED:
-			cout << "Stopped" << endl;
+			cout << "Stopped" << '\n';
 			break;
 		case State_ship::DEAD_IN_THE_WATER:
-			cout << "Dead in the water" << endl;
+			cout << "Dead in the water" << '\n';
 			break;
 		default:
 			// this should never happen, because the other states are covered in the previous switch
@@ -109,9 +111,59 @@ void Ship::describe() const
 void Ship::broadcast_current_state()
 {
 	Model *model = Model::get_Instance();
-	model->notify_location_ship(get_name(), get_location());
-	model->notify_course_speed(get_name(), track.get_course(), track.get_speed());
-	model->notify_fuel(get_name(), fuel);
+	model->notify_location_ship(get_id(), get_location());
+	model->notify_course_speed(get_id(), get_course(), get_speed());
+	model->notify_fuel(get_id(), get_fuel());
+}
+
+// a moving ship's next event is arriving or running out of fuel; otherwise
+// its updates only report its state, so it has no events
+int Ship::get_next_event_delay() const
+{
+	switch(get_state())
+	{
+		case State_ship::MOVING_ON_COURSE:
+		case State_ship::MOVING_TO_POSITION:
+			{
+				int steps = store().get_steady_steps(slot);
+				return steps >= NO_EVENT_DELAY ? NO_EVENT_DELAY : steps + 1;
+			}
+		case State_ship::SUNK:
+			return 1;
+		default:
+			return NO_EVENT_DELAY;
+	}
+}
+
+// move in a straight line for the supplied number of hours
+void Ship::advance_quietly(int hours)
+{
+	if (!is_moving()) return;
+	store().advance_steps(slot, hours);
+	broadcast_current_state();
+}
+
+void Ship::save_state(Snapshot_writer& writer) const
+{
+	writer.write_point(store().get_destination(slot));
+	writer.write_double(get_course());
+	writer.write_double(get_speed());
+	writer.write_double(get_fuel());
+	writer.write_int(static_cast<int>(get_state()));
+	writer.write_int(resistance);
+	writer.write_string(docked_at ? docked_at->get_name() : "");
+}
+void Ship::restore_state(Snapshot_reader& reader)
+{
+	store().set_destination(slot, reader.read_point());
+	store().set_course(slot, reader.read_double());
+	store().set_speed(slot, reader.read_double());
+	store().set_fuel(slot, reader.read_double());
+	store().set_state(slot, static_cast<State_ship>(reader.read_enum(int(State_ship::SUNK) + 1)));
+	resistance = reader.read_int();
+	string docked_at_name = reader.read_string();
+	if (docked_at_name.empty()) docked_at.reset();
+	else docked_at = Model::get_Instance()->get_island_ptr(docked_at_name);
 }
 
 /*** Command functions ***/
@@ -121,16 +173,16 @@ void Ship::broadcast_current_state()
 void Ship::set_destination_position_and_speed(Point destination_position, double speed)
 {
 	check_movement_and_speed(speed);
-	destination = destination_position;
-	Compass_vector compass(get_location(), destination);
-	track.set_course(compass.direction);
-	track.set_speed(speed);
-	Model::get_Instance()->notify_course_speed(get_name(), track.get_course(), track.get_speed());
-	ship_state = State_ship::MOVING_TO_POSITION;
+	store().set_destination(slot, destination_position);
+	Compass_vector compass(get_location(), destination_position);
+	store().set_course(slot, compass.direction);
+	store().set_speed(slot, speed);
+	Model::get_Instance()->notify_course_speed(get_id(), get_course(), get_speed());
+	store().set_state(slot, State_ship::MOVING_TO_POSITION);
 	docked_at.reset();
 	cout << get_name() << " will sail on ";
 	print_course_and_speed();
-	cout << " to " << destination << endl;
+	cout << " to " << destination_position << '\n';
 }
 
 // Start moving on a course and speed
@@ -139,14 +191,14 @@ void Ship::set_destination_position_and_speed(Point destination_position, double
 void Ship::set_course_and_speed(double course, double speed)
 {
 	check_movement_and_speed(speed);
-	track.set_course(course);
-	track.set_speed(speed);
-	Model::get_Instance()->notify_course_speed(get_name(), track.get_course(), track.get_speed());
-	ship_state = State_ship::MOVING_ON_COURSE;
+	store().set_course(slot, course);
+	store().set_speed(slot, speed);
+	Model::get_Instance()->notify_course_speed(get_id(), get_course(), get_speed());
+	store().set_state(slot, State_ship::MOVING_ON_COURSE);
 	docked_at.reset();
 	cout << get_name() << " will sail on ";
 	print_course_and_speed();
-	cout << endl;
+	cout << '\n';
 }
 
 // Stop moving
@@ -157,11 +209,11 @@ void Ship::stop()
 	{
 		throw Error("Ship cannot move!");
 	}
-	track.set_speed(0);
-	Model::get_Instance()->notify_course_speed(get_name(), track.get_course(), track.get_speed());
-	ship_state = State_ship::STOPPED;
+	store().set_speed(slot, 0);
+	Model::get_Instance()->notify_course_speed(get_id(), get_course(), get_speed());
+	store().set_state(slot, State_ship::STOPPED);
 	docked_at.reset();
-	cout << get_name() << " stopping at " << get_location() << endl;
+	cout << get_name() << " stopping at " << get_location() << '\n';
 }
 
 // dock at an Island - set our position = Island's position, go into Docked state
@@ -173,30 +225,30 @@ void Ship::dock(shared_ptr<Island> island_ptr)
 	{
 		throw Error("Can't dock!");
 	}
-	track.set_position(island_ptr->get_location());
-	Model::get_Instance()->notify_location_ship(get_name(), get_location());
+	store().set_position(slot, island_ptr->get_location());
+	Model::get_Instance()->notify_location_ship(get_id(), get_location());
 	docked_at = island_ptr;
-	ship_state = State_ship::DOCKED;
-	cout << get_name() << " docked at " << island_ptr->get_name() << endl;
+	store().set_state(slot, State_ship::DOCKED);
+	cout << get_name() << " docked at " << island_ptr->get_name() << '\n';
 }
 
 // Refuel - must already be docked at an island; fill takes as much as possible
 // may throw Error("Must be docked!");
 void Ship::refuel()
 {
-	if (ship_state != State_ship::DOCKED)
+	if (get_state() != State_ship::DOCKED)
 	{
 		throw Error("Must be docked!");
 	}
-	double fuel_needed = fuel_capacity - fuel;
+	double fuel_needed = fuel_capacity - get_fuel();
 	if (fuel_needed < REFUEL_MIN)
 	{
-		fuel = fuel_capacity;
+		store().set_fuel(slot, fuel_capacity);
 		return;
 	}
-	fuel += docked_at->provide_fuel(fuel_needed);
-	Model::get_Instance()->notify_fuel(get_name(), fuel);
-	cout << get_name() << " now has " << fuel << " tons of fuel" << endl;
+	store().set_fuel(slot, get_fuel() + docked_at->provide_fuel(fuel_needed));
+	Model::get_Instance()->notify_fuel(get_id(), get_fuel());
+	cout << get_name() << " now has " << get_fuel() << " tons of fuel" << '\n';
 }
 
 /*** Fat interface command functions ***/
@@ -225,21 +277,31 @@ void Ship::stop_attack()
 	throw Error(CANNOT_ATTACK_MSG);
 }
 
+// will always throw Error("Cannot attack!");
+void Ship::set_auto_attack(bool)
+{
+	throw Error(CANNOT_ATTACK_MSG);
+}
+
+// will always throw Error("Cannot plan a cruise route!");
+void Ship::set_route_planning(bool)
+{
+	throw Error("Cannot plan a cruise route!");
+}
+
 // interactions with other objects
 // receive a hit from an attacker
 void Ship::receive_hit(int hit_force, shared_ptr<Ship> attacker_ptr)
 {
 	resistance -= hit_force;
-	cout << get_name() << " hit with " << hit_force << ", resistance now " << resistance << endl;
+	cout << get_name() << " hit with " << hit_force << ", resistance now " << resistance << '\n';
 	if (resistance < 0)
 	{
-		ship_state = State_ship::SUNK;
+		store().set_state(slot, State_ship::SUNK);
 		docked_at.reset();
-		track.set_speed(0);
-		Model *model = Model::get_Instance();
-		model->notify_gone(get_name());
-		model->remove_ship(dynamic_pointer_cast<Ship, Sim_object>(shared_from_this()));
-		cout << get_name() << " sunk" << endl;
+		store().set_speed(slot, 0);
+		Model::get_Instance()->remove_ship(dynamic_pointer_cast<Ship, Sim_object>(shared_from_this()));
+		cout << get_name() << " sunk" << '\n';
 	}
 }
 
@@ -247,71 +309,13 @@ void Ship::receive_hit(int hit_force, shared_ptr<Ship> attacker_ptr)
 
 /*
 Calculate the new position of a ship based on how it is moving, its speed, and
-fuel state. This function should be called only if the state is 
-MOVING_TO_POSITION or MOVING_ON_COURSE.
-
-Track_base has an update_position(double time) function that computes the new position
-of an object after the specified time has elapsed. If the Ship is going to move
-for a full time unit (one hour), then it will get go the "full step" distance,
-so update_position would be called with time = 1.0. If we can move less than that,
-e.g. due to not enough fuel, update position  will be called with the corresponding
-time less than 1.0.
-
-For clarity in specifying the computation, this code assumes the specified private variable names, 
-but you may change the variable names or enum class names, or state names if you wish (e.g. movement_state).
+fuel state. This function should be called only if the state is
+MOVING_TO_POSITION or MOVING_ON_COURSE. The movement itself is computed by the
+Ship_state_store, usually for all moving ships at once at the start of the update.
 */
 void Ship::calculate_movement()
 {
-	// Compute values for how much we need to move, and how much we can, and how long we can,
-	// given the fuel state, then decide what to do.
-	double time = 1.0;	// "full step" time
-	// get the distance to destination
-	double destination_distance = cartesian_distance(get_location(), destination);
-	// get full step distance we can move on this time step
-	double full_distance = track.get_speed() * time;
-	// get fuel required for full step distance
-	double full_fuel_required = full_distance * fuel_consumption;	// tons = nm * tons/nm
-	// how far and how long can we sail in this time period based on the fuel state?
-	double distance_possible, time_possible;
-	if(full_fuel_required <= fuel)
-	{
-		distance_possible = full_distance;
-		time_possible = time;
-	}
-	else
-	{
-		distance_possible = fuel / fuel_consumption;	// nm = tons / tons/nm
-		time_possible = (distance_possible / full_distance) * time;
-	}
-	
-	// are we are moving to a destination, and is the destination within the distance possible?
-	if(ship_state == State_ship::MOVING_TO_POSITION && destination_distance <= distance_possible)
-	{
-		// yes, make our new position the destination
-		track.set_position(destination);
-		// we travel the destination distance, using that much fuel
-		double fuel_required = destination_distance * fuel_consumption;
-		fuel -= fuel_required;
-		track.set_speed(0.);
-		ship_state = State_ship::STOPPED;
-	}
-	else
-	{
-		// go as far as we can, stay in the same movement state
-		// simply move for the amount of time possible
-		track.update_position(time_possible);
-		// have we used up our fuel?
-		if(full_fuel_required >= fuel)
-		{
-			fuel = 0.0;
-            track.set_speed(0.);
-			ship_state = State_ship::DEAD_IN_THE_WATER;
-		}
-		else
-		{
-			fuel -= full_fuel_required;
-		}
-	}
+	store().commit_move(slot);
 	broadcast_current_state();
 }
 
@@ -331,5 +335,5 @@ void Ship::check_movement_and_speed(double speed)
 // Prints the course and speed
 void Ship::print_course_and_speed() const
 {
-	cout << "course " << track.get_course() << " deg, speed " << track.get_speed() << " nm/hr";
+	cout << "course " << get_course() << " deg, speed " << get_speed() << " nm/hr";
 }
\ No newline at end of file
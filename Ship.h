@@ -2,7 +2,7 @@
 #define SHIP_H
 
 #include "Sim_object.h"
-#include "Track_base.h"
+#include "Ship_state_store.h"
 #include "Model.h"
 #include "Geometry.h"
 #include <string>
@@ -16,8 +16,9 @@ The initial amount of fuel is equal to the supplied fuel capacity - a full fuel
 A Ship can be commanded to move to either a position or follow a course, or stop,
 dock at or refuel at an Island. It consumes fuel while moving, and becomes immobile
 if it runs out of fuel. It inherits the Sim_object interface to the rest of the system,
-and the Track_base class provides the basic movement functionality, with the unit of time
-corresponding to 1.0 for one "tick" - an hour of simulated time.
+and the Ship_state_store holds its position, course, speed, fuel, and state and provides
+the basic movement functionality, with the unit of time corresponding to 1.0 for one
+"tick" - an hour of simulated time.
 
 The update function updates the position and/or state of the ship.
 The describe function outputs information about the ship state.
@@ -26,8 +27,6 @@ The is a "fat interface" for the capabilities of derived types of Ships. These
 functions are implemented in this class to throw an Error exception.
 */
 
-enum class State_ship {DOCKED, STOPPED, MOVING_TO_POSITION, MOVING_ON_COURSE, DEAD_IN_THE_WATER, SUNK};
-
 class Ship : public Sim_object {
 public:
     // output destructor message
@@ -36,31 +35,38 @@ public:
     /*** Readers ***/
     // return the current position
     Point get_location() const override {
-        return track.get_position();
+        return store().get_position(slot);
+    }
+
+    // return the slot holding this ship's state in the Ship_state_store
+    int get_slot() const
+    {
+        return slot;
     }
 
     // Return true if ship can move (it is not dead in the water or in the process or sinking);
     bool can_move() const
     {
-        return is_afloat() && ship_state != State_ship::DEAD_IN_THE_WATER;
+        return is_afloat() && get_state() != State_ship::DEAD_IN_THE_WATER;
     }
 
     // Return true if ship is moving;
     bool is_moving() const
     {
+        State_ship ship_state = get_state();
         return ship_state == State_ship::MOVING_ON_COURSE || ship_state == State_ship::MOVING_TO_POSITION;
     }
 
     // Return true if ship is docked;
     bool is_docked() const
     {
-        return ship_state == State_ship::DOCKED;
+        return get_state() == State_ship::DOCKED;
     }
 
     // Return true if ship is afloat (not in process of sinking), false if not
     bool is_afloat() const
     {
-        return ship_state != State_ship::SUNK;
+        return get_state() != State_ship::SUNK;
     }
 
     // Return true if the ship is Stopped and the distance to the supplied island
@@ -69,19 +75,33 @@ public:
 
     double get_fuel() const
     {
-        return fuel;
+        return store().get_fuel(slot);
     }
 
     double get_course() const
     {
-        return track.get_course();
+        return store().get_course(slot);
     }
 
     double get_speed() const
     {
-        return track.get_speed();
+        return store().get_speed(slot);
     }
 
+    double get_maximum_speed() const
+    {
+        return max_speed;
+    }
+
+    // return the velocity in nm/hr as a Cartesian vector
+    Cartesian_vector get_velocity() const
+    {
+        return store().get_velocity(slot);
+    }
+
+    // return the type of the ship, as supplied to create_ship
+    virtual std::string get_type_name() const = 0;
+
     /*** Interface to derived classes ***/
     // Update the state of the Ship
     void update() override;
@@ -91,6 +111,15 @@ public:
 
     void broadcast_current_state() override;
 
+    // a moving ship's next event is arriving or running out of fuel; otherwise
+    // its updates only report its state, so it has no events
+    int get_next_event_delay() const override;
+    // move in a straight line for the supplied number of hours
+    void advance_quietly(int hours) override;
+
+    void save_state(Snapshot_writer& writer) const override;
+    void restore_state(Snapshot_reader& reader) override;
+
     /*** Command functions ***/
     // Start moving to a destination position at a speed
     // may throw Error("Ship cannot move!")
@@ -128,6 +157,12 @@ public:
     // will always throw Error("Cannot attack!");
     virtual void stop_attack();
 
+    // will always throw Error("Cannot attack!");
+    virtual void set_auto_attack(bool auto_attack);
+
+    // will always throw Error("Cannot plan a cruise route!");
+    virtual void set_route_planning(bool planned);
+
     // interactions with other objects
     // receive a hit from an attacker
     virtual void receive_hit(int hit_force, std::shared_ptr<Ship> attacker_ptr);
@@ -141,11 +176,6 @@ protected:
     Ship(const std::string &name_, Point position_, double fuel_capacity_,
             double maximum_speed_, double fuel_consumption_, int resistance_);
 
-    double get_maximum_speed() const
-    {
-        return max_speed;
-    }
-
     // return pointer to the Island currently docked at, or nullptr if not docked
     std::shared_ptr<Island> get_docked_Island() const
     {
@@ -153,18 +183,25 @@ protected:
     }
 
 private:
-    double fuel;                        // Current amount of fuel
-    double fuel_consumption;            // tons/nm required
+    int slot;                           // Slot holding this ship's state in the Ship_state_store
     double fuel_capacity;               // Maximum fuel capacity
-    Point destination;                    // Current destination if any
-    Track_base track;                   // Track_base of this ship
 
     double max_speed;                   // Maximum speed
     int resistance;                  // Resistance of ship
 
-    State_ship ship_state;                   // Current state of the ship
     std::shared_ptr<Island> docked_at;                     // If docked, the island the ship is docked at
 
+    // the store holding the movement state of all ships
+    static Ship_state_store& store()
+    {
+        return *Ship_state_store::get_Instance();
+    }
+
+    State_ship get_state() const
+    {
+        return store().get_state(slot);
+    }
+
     // Updates position, fuel, and movement_state, assuming 1 time unit (1 hr)
     void calculate_movement();
 
@@ -4,6 +4,7 @@
 #include "Tanker.h"
 #include "Cruiser.h"
 #include "Cruise_ship.h"
+#include "Slab_pool.h"
 
 using namespace std;
 
@@ -11,18 +12,38 @@ const string FACTORY_TANKER_TYPE = "Tanker";
 const string FACTORY_CRUISER_TYPE = "Cruiser";
 const string FACTORY_CRUISE_SHIP_TYPE = "Cruise_ship";
 
+// the pools are never destroyed, since ships may outlive any static object
+static Slab_pool& tanker_pool = *new Slab_pool(FACTORY_TANKER_TYPE);
+static Slab_pool& cruiser_pool = *new Slab_pool(FACTORY_CRUISER_TYPE);
+static Slab_pool& cruise_ship_pool = *new Slab_pool(FACTORY_CRUISE_SHIP_TYPE);
+
 // may throw Error("Trying to create ship of unknown type!")
 shared_ptr<Ship> create_ship(const string& name, const string& type, Point initial_position)
 {
     if (type == FACTORY_TANKER_TYPE)
     {
-        return shared_ptr<Ship>(make_shared<Tanker>(name, initial_position));
+        return shared_ptr<Ship>(allocate_shared<Tanker>(Pool_allocator<Tanker>(&tanker_pool), name, initial_position));
     } else if (type == FACTORY_CRUISER_TYPE)
     {
-        return shared_ptr<Ship>(make_shared<Cruiser>(name, initial_position));
+        return shared_ptr<Ship>(allocate_shared<Cruiser>(Pool_allocator<Cruiser>(&cruiser_pool), name, initial_position));
     } else if (type == FACTORY_CRUISE_SHIP_TYPE)
     {
-        return shared_ptr<Ship>(make_shared<Cruise_ship>(name, initial_position));
+        return shared_ptr<Ship>(allocate_shared<Cruise_ship>(Pool_allocator<Cruise_ship>(&cruise_ship_pool),
+                name, initial_position));
     }
     throw Error("Trying to create ship of unknown type!");
-}
\ No newline at end of file
+}
+
+// is type one that create_ship can create?
+bool is_ship_type(const string& type)
+{
+    return type == FACTORY_TANKER_TYPE || type == FACTORY_CRUISER_TYPE || type == FACTORY_CRUISE_SHIP_TYPE;
+}
+
+// output the occupancy of the pool of each type of ship
+void describe_ship_pools()
+{
+    tanker_pool.describe();
+    cruiser_pool.describe();
+    cruise_ship_pool.describe();
+}
@@ -8,11 +8,18 @@ struct Point;
 class Ship;
 
 /* This is a very simple form of factory, a function; you supply the information, it creates
-the specified kind of object and returns a pointer to it. The Ship is allocated
-with new, so some other component is responsible for deleting it.
+the specified kind of object and returns a pointer to it. Each kind of Ship is allocated,
+together with its reference counts, from a Slab_pool of its own, and its slot is reused
+once the last pointer to the Ship is gone.
 */
 
 // may throw Error("Trying to create ship of unknown type!")
 std::shared_ptr<Ship> create_ship(const std::string& name, const std::string& type, Point initial_position);
 
+// is type one that create_ship can create?
+bool is_ship_type(const std::string& type);
+
+// output the occupancy of the pool of each type of ship
+void describe_ship_pools();
+
 #endif
@@ -0,0 +1,245 @@
+#include "Ship_state_store.h"
+#include "Navigation.h"
+#include "Utility.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+Ship_state_store* Ship_state_store::store = 0;
+
+Ship_state_store* Ship_state_store::get_Instance()
+{
+    if (!store) store = new Ship_state_store;
+    return store;
+}
+
+// allocate a slot for a new stopped ship, and return its index
+int Ship_state_store::allocate(Point position, double fuel_, double fuel_consumption_)
+{
+    int slot;
+    if (free_slots.empty())
+    {
+        slot = int(x.size());
+        x.push_back(0.);
+        y.push_back(0.);
+        course.push_back(0.);
+        course_x.push_back(0.);
+        course_y.push_back(0.);
+        speed.push_back(0.);
+        fuel.push_back(0.);
+        fuel_consumption.push_back(0.);
+        dest_x.push_back(0.);
+        dest_y.push_back(0.);
+        state.push_back(State_ship::STOPPED);
+        next_x.push_back(0.);
+        next_y.push_back(0.);
+        next_speed.push_back(0.);
+        next_fuel.push_back(0.);
+        next_state.push_back(State_ship::STOPPED);
+        pending.push_back(0);
+    }
+    else
+    {
+        slot = free_slots.back();
+        free_slots.pop_back();
+    }
+    x[slot] = position.x;
+    y[slot] = position.y;
+    set_course(slot, 0.);
+    speed[slot] = 0.;
+    fuel[slot] = fuel_;
+    fuel_consumption[slot] = fuel_consumption_;
+    dest_x[slot] = 0.;
+    dest_y[slot] = 0.;
+    state[slot] = State_ship::STOPPED;
+    pending[slot] = 0;
+    return slot;
+}
+
+// return the slot to the store for reuse
+void Ship_state_store::release(int slot)
+{
+    // a released slot is treated as sunk so that a sweep skips it
+    state[slot] = State_ship::SUNK;
+    pending[slot] = 0;
+    free_slots.push_back(slot);
+}
+
+/*** Writers - each discards any pending move of the slot ***/
+void Ship_state_store::set_position(int slot, Point position)
+{
+    x[slot] = position.x;
+    y[slot] = position.y;
+    pending[slot] = 0;
+}
+void Ship_state_store::set_destination(int slot, Point destination)
+{
+    dest_x[slot] = destination.x;
+    dest_y[slot] = destination.y;
+    pending[slot] = 0;
+}
+void Ship_state_store::set_course(int slot, double course_)
+{
+    course[slot] = course_;
+    Cartesian_vector unit = compass_unit_vector(course_);
+    course_x[slot] = unit.delta_x;
+    course_y[slot] = unit.delta_y;
+    pending[slot] = 0;
+}
+void Ship_state_store::set_speed(int slot, double speed_)
+{
+    speed[slot] = speed_;
+    pending[slot] = 0;
+}
+void Ship_state_store::set_fuel(int slot, double fuel_)
+{
+    fuel[slot] = fuel_;
+    pending[slot] = 0;
+}
+void Ship_state_store::set_state(int slot, State_ship state_)
+{
+    state[slot] = state_;
+    pending[slot] = 0;
+}
+
+/*** Movement ***/
+// compute the pending moves of the slots in [begin, end)
+void Ship_state_store::compute_moves(int begin, int end)
+{
+    for (int slot = begin; slot < end; slot++)
+    {
+        if (is_moving(slot)) compute_move(slot);
+        else pending[slot] = 0;
+    }
+}
+
+// make the slot's pending move current, computing it first if needed
+void Ship_state_store::commit_move(int slot)
+{
+    assert(is_moving(slot));
+    if (!pending[slot]) compute_move(slot);
+    x[slot] = next_x[slot];
+    y[slot] = next_y[slot];
+    speed[slot] = next_speed[slot];
+    fuel[slot] = next_fuel[slot];
+    state[slot] = next_state[slot];
+    pending[slot] = 0;
+}
+
+// discard all pending moves
+void Ship_state_store::discard_moves()
+{
+    fill(pending.begin(), pending.end(), 0);
+}
+
+// return where the slot will be after its move in this time unit
+Point Ship_state_store::get_moved_position(int slot)
+{
+    if (!is_moving(slot)) return get_position(slot);
+    if (!pending[slot]) compute_move(slot);
+    return Point(next_x[slot], next_y[slot]);
+}
+
+// return the number of full steps the moving ship can certainly make.
+// Two steps are held back so that the last steps before an arrival or running
+// out of fuel are always made by compute_move, whatever the rounding errors.
+int Ship_state_store::get_steady_steps(int slot) const
+{
+    assert(is_moving(slot));
+    double steps = NO_EVENT_DELAY;
+    double full_fuel_required = speed[slot] * fuel_consumption[slot];
+    if (full_fuel_required > 0.) steps = min(steps, floor(fuel[slot] / full_fuel_required) - 2.);
+    if (state[slot] == State_ship::MOVING_TO_POSITION)
+    {
+        double destination_distance = cartesian_distance(get_position(slot), get_destination(slot));
+        if (speed[slot] > 0.) steps = min(steps, floor(destination_distance / speed[slot]) - 2.);
+        else if (destination_distance == 0.) steps = 0.;
+    }
+    return steps > 0. ? int(steps) : 0;
+}
+
+// make the supplied number of full steps at once
+void Ship_state_store::advance_steps(int slot, int steps)
+{
+    assert(is_moving(slot));
+    Point position = position_after(slot, speed[slot] * double(steps));
+    x[slot] = position.x;
+    y[slot] = position.y;
+    fuel[slot] -= steps * speed[slot] * fuel_consumption[slot];
+    pending[slot] = 0;
+}
+
+/*
+Calculate the new position of a ship based on how it is moving, its speed, and
+fuel state. This function should be called only if the state is
+MOVING_TO_POSITION or MOVING_ON_COURSE.
+
+A course and speed multiplied by a time gives the displacement of the ship after
+that time has elapsed. If the Ship is going to move for a full time unit (one hour),
+then it will get go the "full step" distance, so the time is 1.0. If we can move less
+than that, e.g. due to not enough fuel, the time will be the corresponding
+time less than 1.0.
+*/
+void Ship_state_store::compute_move(int slot)
+{
+    Point position(x[slot], y[slot]);
+    Point destination(dest_x[slot], dest_y[slot]);
+    double new_fuel = fuel[slot];
+    // Compute values for how much we need to move, and how much we can, and how long we can,
+    // given the fuel state, then decide what to do.
+    double time = 1.0;	// "full step" time
+    // get the distance to destination
+    double destination_distance = cartesian_distance(position, destination);
+    // get full step distance we can move on this time step
+    double full_distance = speed[slot] * time;
+    // get fuel required for full step distance
+    double full_fuel_required = full_distance * fuel_consumption[slot];	// tons = nm * tons/nm
+    // how far and how long can we sail in this time period based on the fuel state?
+    double distance_possible, time_possible;
+    if(full_fuel_required <= new_fuel)
+    {
+        distance_possible = full_distance;
+        time_possible = time;
+    }
+    else
+    {
+        distance_possible = new_fuel / fuel_consumption[slot];	// nm = tons / tons/nm
+        time_possible = (distance_possible / full_distance) * time;
+    }
+
+    // are we are moving to a destination, and is the destination within the distance possible?
+    if(state[slot] == State_ship::MOVING_TO_POSITION && destination_distance <= distance_possible)
+    {
+        // yes, make our new position the destination
+        position = destination;
+        // we travel the destination distance, using that much fuel
+        new_fuel -= destination_distance * fuel_consumption[slot];
+        next_speed[slot] = 0.;
+        next_state[slot] = State_ship::STOPPED;
+    }
+    else
+    {
+        // go as far as we can, stay in the same movement state
+        // simply move for the amount of time possible, along the unit vector of the course
+        position = position_after(slot, speed[slot] * time_possible);
+        next_speed[slot] = speed[slot];
+        next_state[slot] = state[slot];
+        // have we used up our fuel?
+        if(full_fuel_required >= new_fuel)
+        {
+            new_fuel = 0.0;
+            next_speed[slot] = 0.;
+            next_state[slot] = State_ship::DEAD_IN_THE_WATER;
+        }
+        else
+        {
+            new_fuel -= full_fuel_required;
+        }
+    }
+    next_x[slot] = position.x;
+    next_y[slot] = position.y;
+    next_fuel[slot] = new_fuel;
+    pending[slot] = 1;
+}
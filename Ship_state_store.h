@@ -0,0 +1,136 @@
+#ifndef SHIP_STATE_STORE_H
+#define SHIP_STATE_STORE_H
+
+#include "Geometry.h"
+#include <vector>
+
+/* Ship_state_store
+The Ship_state_store keeps the movement-relevant state of every Ship - position, course,
+speed, fuel, fuel consumption, destination, and state - in contiguous parallel arrays
+(a structure of arrays), indexed by a slot number that each Ship holds. A Ship is a thin
+handle over its slot.
+
+Movement is done in two steps. compute_moves() advances every moving ship by one time
+unit in a single pass over the arrays, but saves the results as pending values. During
+its own update, each Ship then commits its pending move. In this way other objects
+see exactly the positions they would see if the ships moved one at a time in
+name order, while the arithmetic is done in one linear sweep. Any change made to
+a slot discards its pending move, so a later commit recomputes it from the current state.
+
+compute_moves is the one batch movement path in the program. The course is kept as a
+unit vector beside the course angle, so the sweep has no trigonometry, and it reads and
+writes only these arrays of doubles, in slot order - the layout that lets the compiler
+vectorize it, and lets the slots be split among threads.
+
+Like the Model, there is only one Ship_state_store.
+*/
+
+enum class State_ship {DOCKED, STOPPED, MOVING_TO_POSITION, MOVING_ON_COURSE, DEAD_IN_THE_WATER, SUNK};
+
+class Ship_state_store {
+public:
+    static Ship_state_store* get_Instance();
+
+    // allocate a slot for a new stopped ship, and return its index
+    int allocate(Point position, double fuel, double fuel_consumption);
+    // return the slot to the store for reuse
+    void release(int slot);
+
+    /*** Readers ***/
+    Point get_position(int slot) const
+        {return Point(x[slot], y[slot]);}
+    Point get_destination(int slot) const
+        {return Point(dest_x[slot], dest_y[slot]);}
+    double get_course(int slot) const
+        {return course[slot];}
+    double get_speed(int slot) const
+        {return speed[slot];}
+    // the velocity in nm/hr
+    Cartesian_vector get_velocity(int slot) const
+        {return Cartesian_vector(course_x[slot] * speed[slot], course_y[slot] * speed[slot]);}
+    double get_fuel(int slot) const
+        {return fuel[slot];}
+    State_ship get_state(int slot) const
+        {return state[slot];}
+
+    /*** Writers - each discards any pending move of the slot ***/
+    void set_position(int slot, Point position);
+    void set_destination(int slot, Point destination);
+    void set_course(int slot, double course_);
+    void set_speed(int slot, double speed_);
+    void set_fuel(int slot, double fuel_);
+    void set_state(int slot, State_ship state_);
+
+    // the number of slots, including released ones
+    int get_size() const
+        {return int(x.size());}
+
+    /*** Movement ***/
+    // compute the pending move of every ship that is moving, in one pass
+    void compute_moves()
+        {compute_moves(0, get_size());}
+    // compute the pending moves of the slots in [begin, end); calls for
+    // separate ranges touch separate data, so they may run in parallel
+    void compute_moves(int begin, int end);
+    // make the slot's pending move current, computing it first if needed;
+    // the ship must be in one of the moving states
+    void commit_move(int slot);
+    // discard all pending moves
+    void discard_moves();
+    // return where the slot will be after its move in this time unit, computing the
+    // pending move if needed; a slot that is not moving stays where it is
+    Point get_moved_position(int slot);
+
+    // return the number of full steps the moving ship can certainly make without
+    // reaching its destination or running out of fuel, at most NO_EVENT_DELAY
+    int get_steady_steps(int slot) const;
+    // make the supplied number of full steps at once; the ship must be able to
+    // make them without reaching its destination or running out of fuel
+    void advance_steps(int slot, int steps);
+
+    // disallow copy/move construction or assignment
+    Ship_state_store(const Ship_state_store&) = delete;
+    Ship_state_store& operator=(const Ship_state_store&) = delete;
+
+private:
+    Ship_state_store() {}
+    static Ship_state_store* store;
+
+    // current state
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> course;
+    std::vector<double> course_x;   // unit vector along the course, recomputed only when it is set
+    std::vector<double> course_y;
+    std::vector<double> speed;
+    std::vector<double> fuel;
+    std::vector<double> fuel_consumption;   // tons/nm required
+    std::vector<double> dest_x;
+    std::vector<double> dest_y;
+    std::vector<State_ship> state;
+
+    // result of the last compute_moves, valid only where pending is nonzero
+    std::vector<double> next_x;
+    std::vector<double> next_y;
+    std::vector<double> next_speed;
+    std::vector<double> next_fuel;
+    std::vector<State_ship> next_state;
+    std::vector<char> pending;
+
+    std::vector<int> free_slots;
+
+    // compute the pending move for one slot
+    void compute_move(int slot);
+    // move the slot's position the supplied distance along its course
+    Point position_after(int slot, double distance) const
+    {
+        return Point(x[slot] + course_x[slot] * distance, y[slot] + course_y[slot] * distance);
+    }
+
+    bool is_moving(int slot) const
+    {
+        return state[slot] == State_ship::MOVING_ON_COURSE || state[slot] == State_ship::MOVING_TO_POSITION;
+    }
+};
+
+#endif
@@ -1,15 +1,16 @@
 #include "Sim_object.h"
+#include "Model.h"
 #include "Utility.h"
 #include <iostream>
 
 using namespace std;
 
-Sim_object::Sim_object(const std::string& name_) : name(name_)
+Sim_object::Sim_object(const std::string& name_) : name(name_), id(Model::intern_name(name_))
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Sim_object " << get_name() << " constructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Sim_object " << get_name() << " constructed" << '\n';
 }
 
 Sim_object::~Sim_object()
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Sim_object " << get_name() << " destructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Sim_object " << get_name() << " destructed" << '\n';
 }
\ No newline at end of file
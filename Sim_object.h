@@ -8,6 +8,8 @@ and other information. */
 #include <memory>
 
 struct Point;
+class Snapshot_writer;
+class Snapshot_reader;
 
 class Sim_object : public std::enable_shared_from_this<Sim_object> {
 public:
@@ -16,6 +18,9 @@ public:
 	
 	const std::string& get_name() const
 		{return name;}
+	// the dense integer ID of the name, used in place of it in notifications
+	int get_id() const
+		{return id;}
     
 	// ask model to notify views of current state
     virtual void broadcast_current_state() {}
@@ -25,11 +30,27 @@ public:
 	virtual void describe() const = 0;
 	virtual void update() = 0;
 
+	/* Event-driven time advance */
+	// return the number of hours until the next update that does more than steady progress,
+	// or NO_EVENT_DELAY if there is none; by default every update is an event
+	virtual int get_next_event_delay() const
+		{return 1;}
+	// make the steady progress of the supplied number of hours without any output
+	virtual void advance_quietly(int hours) {}
+
+	/* Snapshots - the name and location are saved by the Model */
+	// write the rest of the object's state; a derived class writes its base's state first
+	virtual void save_state(Snapshot_writer& writer) const = 0;
+	// read back the state written by save_state, without any output; every object
+	// in the snapshot is already present in the Model
+	virtual void restore_state(Snapshot_reader& reader) = 0;
+
 protected:
 	Sim_object(const std::string& name_);
 	
 private:
 	std::string name;
+	int id;
 };
 
 
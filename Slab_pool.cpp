@@ -0,0 +1,67 @@
+#include "Slab_pool.h"
+#include <algorithm>
+#include <iostream>
+#include <new>
+
+using namespace std;
+
+// the number of slots in each slab
+const int SLAB_POOL_SLOTS_PER_SLAB = 64;
+
+// name_ is used when describing the pool
+Slab_pool::Slab_pool(const string& name_) :
+    name(name_), slot_size(0), slots_per_slab(SLAB_POOL_SLOTS_PER_SLAB), free_slots(nullptr), slots_in_use(0)
+{
+}
+
+Slab_pool::~Slab_pool()
+{
+    assert(slots_in_use == 0);
+    for (char* slab : slabs) ::operator delete(slab);
+}
+
+// return a slot of the supplied size, adding a slab if there is no free slot
+void* Slab_pool::allocate(size_t size)
+{
+    if (!slot_size)
+    {
+        // round the slots up so that every one is aligned for any object
+        size_t alignment = alignof(max_align_t);
+        slot_size = (max(size, sizeof(Free_slot)) + alignment - 1) / alignment * alignment;
+    }
+    assert(size <= slot_size);
+    if (!free_slots) add_slab();
+    Free_slot* slot = free_slots;
+    free_slots = slot->next;
+    ++slots_in_use;
+    return slot;
+}
+
+// put the slot back on the free list
+void Slab_pool::deallocate(void* slot)
+{
+    Free_slot* free_slot = static_cast<Free_slot*>(slot);
+    free_slot->next = free_slots;
+    free_slots = free_slot;
+    --slots_in_use;
+}
+
+// output the number of slots in use and the number of slots in the slabs
+void Slab_pool::describe() const
+{
+    cout << name << " pool: " << slots_in_use << " of " << get_slot_count() << " slots in use, "
+            << slabs.size() << " slabs of " << slots_per_slab << " slots of " << slot_size << " bytes" << '\n';
+}
+
+// add a slab and put its slots on the free list, the first slot first
+void Slab_pool::add_slab()
+{
+    char* slab = static_cast<char*>(::operator new(slot_size * slots_per_slab));
+    slabs.push_back(slab);
+    for (int i = slots_per_slab - 1; i >= 0; i--)
+    {
+        Free_slot* slot = reinterpret_cast<Free_slot*>(slab + i * slot_size);
+        slot->next = free_slots;
+        free_slots = slot;
+    }
+}
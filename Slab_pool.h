@@ -0,0 +1,98 @@
+#ifndef SLAB_POOL_H
+#define SLAB_POOL_H
+
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/* Slab_pool
+A Slab_pool hands out memory for objects of one size from slabs, each a block with
+room for a fixed number of them. A slot given back is put on a free list and reused by
+the next allocation, so objects that are created and destroyed over and over use the
+same memory instead of going to the general heap each time, and the slabs are only
+released when the pool is. The size of the slots is set by the first allocation; every
+later one must be of the same size. A pool is not safe for use by several threads.
+
+Pool_allocator is a standard allocator that gets its memory from a Slab_pool, so that
+std::allocate_shared can place an object and its reference counts in a single slot.
+*/
+
+class Slab_pool {
+public:
+    // name_ is used when describing the pool
+    Slab_pool(const std::string& name_);
+    ~Slab_pool();
+
+    // return a slot of the supplied size, adding a slab if there is no free slot
+    void* allocate(std::size_t size);
+    // put the slot back on the free list
+    void deallocate(void* slot);
+
+    // output the number of slots in use and the number of slots in the slabs
+    void describe() const;
+
+    int get_slots_in_use() const
+        {return slots_in_use;}
+    int get_slot_count() const
+        {return int(slabs.size()) * slots_per_slab;}
+
+    // disallow copy/move construction or assignment
+    Slab_pool(const Slab_pool&) = delete;
+    Slab_pool& operator=(const Slab_pool&) = delete;
+
+private:
+    // a free slot holds the next free slot
+    struct Free_slot {
+        Free_slot* next;
+    };
+
+    std::string name;
+    std::size_t slot_size;      // zero until the first allocation
+    int slots_per_slab;
+    std::vector<char*> slabs;
+    Free_slot* free_slots;
+    int slots_in_use;
+
+    void add_slab();
+};
+
+template<typename T>
+class Pool_allocator {
+public:
+    typedef T value_type;
+
+    Pool_allocator(Slab_pool* pool_) : pool(pool_) {}
+    template<typename U>
+    Pool_allocator(const Pool_allocator<U>& other) : pool(other.get_pool()) {}
+
+    // objects are placed one at a time
+    T* allocate(std::size_t n)
+    {
+        assert(n == 1);
+        return static_cast<T*>(pool->allocate(sizeof(T)));
+    }
+    void deallocate(T* p, std::size_t)
+    {
+        pool->deallocate(p);
+    }
+
+    Slab_pool* get_pool() const
+        {return pool;}
+
+private:
+    Slab_pool* pool;
+};
+
+template<typename T, typename U>
+bool operator==(const Pool_allocator<T>& first, const Pool_allocator<U>& second)
+{
+    return first.get_pool() == second.get_pool();
+}
+template<typename T, typename U>
+bool operator!=(const Pool_allocator<T>& first, const Pool_allocator<U>& second)
+{
+    return first.get_pool() != second.get_pool();
+}
+
+#endif
@@ -0,0 +1,134 @@
+#include "Snapshot.h"
+#include "Utility.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+const char SNAPSHOT_MAGIC[8] = {'P', '5', 'S', 'N', 'A', 'P', '\0', '\0'};
+const char* const INVALID_SNAPSHOT_MSG = "Invalid snapshot file!";
+
+// start a snapshot with the header
+Snapshot_writer::Snapshot_writer() : record_start(0)
+{
+    write_bytes(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    uint32_t version = SNAPSHOT_VERSION;
+    write_bytes(&version, sizeof(version));
+}
+
+void Snapshot_writer::write_int(int value)
+{
+    int32_t fixed_value = value;
+    write_bytes(&fixed_value, sizeof(fixed_value));
+}
+void Snapshot_writer::write_double(double value)
+{
+    write_bytes(&value, sizeof(value));
+}
+void Snapshot_writer::write_point(Point point)
+{
+    write_double(point.x);
+    write_double(point.y);
+}
+void Snapshot_writer::write_string(const string& value)
+{
+    uint32_t size = uint32_t(value.size());
+    write_bytes(&size, sizeof(size));
+    write_bytes(value.data(), value.size());
+}
+
+// begin a record, leaving room for its size
+void Snapshot_writer::begin_record()
+{
+    record_start = buffer.size();
+    uint32_t size = 0;
+    write_bytes(&size, sizeof(size));
+}
+// fill in the size of the record
+void Snapshot_writer::end_record()
+{
+    uint32_t size = uint32_t(buffer.size() - record_start - sizeof(size));
+    memcpy(&buffer[record_start], &size, sizeof(size));
+}
+
+// write the whole snapshot to the file
+void Snapshot_writer::write_file(const string& filename) const
+{
+    ofstream file(filename, ios::binary);
+    if (!file || !file.write(buffer.data(), buffer.size())) throw Error("Could not write snapshot file!");
+}
+
+void Snapshot_writer::write_bytes(const void* bytes, size_t size)
+{
+    const char* first = static_cast<const char*>(bytes);
+    buffer.insert(buffer.end(), first, first + size);
+}
+
+// map the file and check its header
+Snapshot_reader::Snapshot_reader(const string& filename) :
+    file(filename, "Could not open snapshot file!"), cursor(file.get_begin()), limit(file.get_end())
+{
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    read_bytes(magic, sizeof(magic));
+    if (memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0) throw Error(INVALID_SNAPSHOT_MSG);
+    uint32_t version;
+    read_bytes(&version, sizeof(version));
+    if (version != SNAPSHOT_VERSION) throw Error("Unsupported snapshot version!");
+}
+
+int Snapshot_reader::read_int()
+{
+    int32_t value;
+    read_bytes(&value, sizeof(value));
+    return value;
+}
+double Snapshot_reader::read_double()
+{
+    double value;
+    read_bytes(&value, sizeof(value));
+    return value;
+}
+Point Snapshot_reader::read_point()
+{
+    double x = read_double();
+    double y = read_double();
+    return Point(x, y);
+}
+int Snapshot_reader::read_enum(int count)
+{
+    int value = read_int();
+    if (value < 0 || value >= count) throw Error(INVALID_SNAPSHOT_MSG);
+    return value;
+}
+string Snapshot_reader::read_string()
+{
+    uint32_t size;
+    read_bytes(&size, sizeof(size));
+    if (size > size_t(limit - cursor)) throw Error(INVALID_SNAPSHOT_MSG);
+    string value(cursor, size);
+    cursor += size;
+    return value;
+}
+
+// enter the record at the cursor; reads are then limited to it
+void Snapshot_reader::begin_record()
+{
+    uint32_t size;
+    read_bytes(&size, sizeof(size));
+    if (size > size_t(limit - cursor)) throw Error(INVALID_SNAPSHOT_MSG);
+    limit = cursor + size;
+}
+// leave the current record, skipping whatever has not been read
+void Snapshot_reader::end_record()
+{
+    cursor = limit;
+    limit = file.get_end();
+}
+
+void Snapshot_reader::read_bytes(void* bytes, size_t size)
+{
+    if (size > size_t(limit - cursor)) throw Error(INVALID_SNAPSHOT_MSG);
+    memcpy(bytes, cursor, size);
+    cursor += size;
+}
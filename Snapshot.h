@@ -0,0 +1,95 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "Mapped_file.h"
+#include "Geometry.h"
+#include <string>
+#include <vector>
+
+/* Snapshots
+A snapshot file holds the complete state of the simulation in a compact binary form.
+It starts with a fixed header - a magic string and a format version number - and then
+holds the time, the islands, and the ships. Each object is a record giving its kind,
+name, and location, followed by the size of its state and the state itself, which is
+written by the object. The sizes let a reader step from record to record without
+understanding their contents, and objects refer to other objects by name.
+Numbers are written in the machine's own binary representation, so a snapshot is
+meant to be loaded on the kind of machine that saved it.
+
+Snapshot_writer collects a snapshot in memory and then writes it to a file in one call.
+Snapshot_reader maps a snapshot file into memory and decodes it in place; a read
+past the end of the current record throws Error("Invalid snapshot file!").
+*/
+
+// the current version of the snapshot format
+const unsigned SNAPSHOT_VERSION = 3;
+
+class Snapshot_writer {
+public:
+    // start a snapshot with the header
+    Snapshot_writer();
+
+    void write_int(int value);
+    void write_double(double value);
+    void write_point(Point point);
+    void write_string(const std::string& value);
+
+    // begin a record, leaving room for its size; end_record fills in the size
+    void begin_record();
+    void end_record();
+
+    // write the whole snapshot to the file
+    // will throw Error("Could not write snapshot file!") if that fails
+    void write_file(const std::string& filename) const;
+
+private:
+    std::vector<char> buffer;
+    size_t record_start;    // position of the size of the current record
+
+    void write_bytes(const void* bytes, size_t size);
+};
+
+class Snapshot_reader {
+public:
+    // map the file and check its header
+    // will throw Error("Could not open snapshot file!") if the file cannot be read,
+    // Error("Invalid snapshot file!") if it is not a snapshot, or
+    // Error("Unsupported snapshot version!") if it is of another version of the format
+    Snapshot_reader(const std::string& filename);
+
+    int read_int();
+    double read_double();
+    Point read_point();
+    std::string read_string();
+    // read the value of an enumeration whose values are 0 to count - 1
+    // will throw Error("Invalid snapshot file!") if it is out of that range
+    int read_enum(int count);
+
+    // enter the record at the cursor; reads are then limited to it
+    void begin_record();
+    // leave the current record, skipping whatever has not been read
+    void end_record();
+
+    // the position of the cursor, for returning to later with seek
+    const char* tell() const
+        {return cursor;}
+    void seek(const char* position)
+        {cursor = position;}
+
+    // is the whole file read?
+    bool at_end() const
+        {return cursor == file.get_end();}
+
+    // disallow copy/move construction or assignment
+    Snapshot_reader(const Snapshot_reader&) = delete;
+    Snapshot_reader& operator=(const Snapshot_reader&) = delete;
+
+private:
+    Mapped_file file;
+    const char* cursor;
+    const char* limit;  // end of the current record, or of the file
+
+    void read_bytes(void* bytes, size_t size);
+};
+
+#endif
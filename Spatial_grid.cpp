@@ -0,0 +1,189 @@
+#include "Spatial_grid.h"
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+using namespace std;
+
+// cell_size_ is the width of each square cell; name_of_id_ gives the names of the IDs
+Spatial_grid::Spatial_grid(double cell_size_, Name_of_id name_of_id_) :
+        cell_size(cell_size_), name_of_id(name_of_id_), min_cx(0), min_cy(0), max_cx(-1), max_cy(-1)
+{
+    assert(cell_size > 0.);
+}
+
+// add the entry, or move it if the ID is already present
+void Spatial_grid::update(int id, Point location)
+{
+    Cell cell = get_cell(location);
+    if (id >= int(id_present.size()))
+    {
+        cell_of_id.resize(id + 1);
+        id_present.resize(id + 1, false);
+    }
+    if (id_present[id])
+    {
+        vector<Entry>& old_entries = cells[cell_of_id[id]];
+        auto entry_it = find_if(old_entries.begin(), old_entries.end(),
+                [id](const Entry& entry){return entry.id == id;});
+        assert(entry_it != old_entries.end());
+        if (cell_of_id[id] == cell)
+        {
+            entry_it->location = location;
+            return;
+        }
+        // swap the entry to the back of its old cell and drop it
+        *entry_it = old_entries.back();
+        old_entries.pop_back();
+        if (old_entries.empty()) cells.erase(cell_of_id[id]);
+    }
+    cell_of_id[id] = cell;
+    id_present[id] = true;
+    cells[cell].push_back(Entry{id, location});
+    if (max_cx < min_cx)
+    {
+        min_cx = max_cx = cell.first;
+        min_cy = max_cy = cell.second;
+    }
+    min_cx = min(min_cx, cell.first);
+    max_cx = max(max_cx, cell.first);
+    min_cy = min(min_cy, cell.second);
+    max_cy = max(max_cy, cell.second);
+}
+
+// remove the entry; no error if the ID is not present
+void Spatial_grid::remove(int id)
+{
+    if (id >= int(id_present.size()) || !id_present[id]) return;
+    auto cell_it = cells.find(cell_of_id[id]);
+    assert(cell_it != cells.end());
+    vector<Entry>& entries = cell_it->second;
+    auto entry_it = find_if(entries.begin(), entries.end(),
+            [id](const Entry& entry){return entry.id == id;});
+    assert(entry_it != entries.end());
+    *entry_it = entries.back();
+    entries.pop_back();
+    if (entries.empty()) cells.erase(cell_it);
+    id_present[id] = false;
+}
+
+void Spatial_grid::clear()
+{
+    cells.clear();
+    cell_of_id.clear();
+    id_present.clear();
+    min_cx = min_cy = 0;
+    max_cx = max_cy = -1;
+}
+
+// return all entries whose distance from center is less than or equal to radius
+vector<Spatial_grid::Entry> Spatial_grid::find_in_radius(Point center, double radius) const
+{
+    vector<Entry> result;
+    for_each_in_radius(center, radius, [&result](const Entry& entry){result.push_back(entry);});
+    return result;
+}
+// call visit on each entry whose distance from center is less than or equal to radius.
+// Only the cells of the square around the circle that lie within the used cells are
+// looked at; if there are more of those than occupied cells, the occupied cells are
+// gone through instead, so a large radius costs no more than looking at every entry.
+void Spatial_grid::for_each_in_radius(Point center, double radius, const function<void(const Entry&)>& visit) const
+{
+    if (max_cx < min_cx) return;
+    int low_cx = get_used_coordinate(center.x - radius, min_cx, max_cx);
+    int high_cx = get_used_coordinate(center.x + radius, min_cx, max_cx);
+    int low_cy = get_used_coordinate(center.y - radius, min_cy, max_cy);
+    int high_cy = get_used_coordinate(center.y + radius, min_cy, max_cy);
+    double box_cells = (double(high_cx) - low_cx + 1.) * (double(high_cy) - low_cy + 1.);
+    if (box_cells > cells.size())
+    {
+        for (auto&& cell_pair : cells)
+        {
+            for (auto&& entry : cell_pair.second)
+            {
+                if (cartesian_distance(center, entry.location) <= radius) visit(entry);
+            }
+        }
+        return;
+    }
+    for (int cx = low_cx; cx <= high_cx; cx++)
+    {
+        for (int cy = low_cy; cy <= high_cy; cy++)
+        {
+            auto cell_it = cells.find(Cell(cx, cy));
+            if (cell_it == cells.end()) continue;
+            for (auto&& entry : cell_it->second)
+            {
+                if (cartesian_distance(center, entry.location) <= radius) visit(entry);
+            }
+        }
+    }
+}
+
+// return up to k entries that are accepted by the supplied function, nearest to center first.
+// The cells are searched in square rings around the center's cell; every location
+// in ring r is at least (r - 1) * cell_size away, so the search stops once k entries
+// have been found that are closer than that, or the rings cover every used cell.
+vector<Spatial_grid::Entry> Spatial_grid::find_nearest(Point center, int k,
+        const function<bool(const Entry&)>& accept, double max_distance) const
+{
+    typedef pair<double, const Entry*> Candidate;
+    auto closer = [this](const Candidate& first, const Candidate& second)
+    {
+        return first.first == second.first ? name_of_id(first.second->id) < name_of_id(second.second->id)
+                : first.first < second.first;
+    };
+    vector<Candidate> best;     // at most k candidates, nearest first
+    vector<Entry> result;
+    if (k <= 0 || max_cx < min_cx) return result;
+
+    Cell center_cell = get_cell(center);
+    int max_ring = max(max(center_cell.first - min_cx, max_cx - center_cell.first),
+            max(center_cell.second - min_cy, max_cy - center_cell.second));
+    for (int ring = 0; ring <= max_ring; ring++)
+    {
+        // every entry in the ring is at least (ring - 1) cells away
+        if (int(best.size()) == k && best.back().first < (ring - 1) * cell_size) break;
+        if ((ring - 1) * cell_size > max_distance) break;
+        for (int cx = center_cell.first - ring; cx <= center_cell.first + ring; cx++)
+        {
+            // only the first and last columns of the ring use all of their rows
+            bool edge_column = cx == center_cell.first - ring || cx == center_cell.first + ring;
+            int step = edge_column ? 1 : 2 * ring;
+            for (int cy = center_cell.second - ring; cy <= center_cell.second + ring; cy += step)
+            {
+                auto cell_it = cells.find(Cell(cx, cy));
+                if (cell_it != cells.end())
+                {
+                    for (auto&& entry : cell_it->second)
+                    {
+                        // the distance is checked first, since accept may be costly
+                        Candidate candidate(cartesian_distance(center, entry.location), &entry);
+                        if (candidate.first > max_distance) continue;
+                        if (int(best.size()) == k && !closer(candidate, best.back())) continue;
+                        if (accept && !accept(entry)) continue;
+                        best.insert(upper_bound(best.begin(), best.end(), candidate, closer), candidate);
+                        if (int(best.size()) > k) best.pop_back();
+                    }
+                }
+            }
+        }
+    }
+    for (auto&& candidate : best) result.push_back(*candidate.second);
+    return result;
+}
+
+// return the cell coordinate of the coordinate, limited to [low, high]; the limits are
+// applied before converting to int, so that a coordinate far outside them cannot overflow
+int Spatial_grid::get_used_coordinate(double coordinate, int low, int high) const
+{
+    double cell_coordinate = floor(coordinate / cell_size);
+    if (cell_coordinate < low) return low;
+    if (cell_coordinate > high) return high;
+    return int(cell_coordinate);
+}
+
+Spatial_grid::Cell Spatial_grid::get_cell(Point location) const
+{
+    return Cell(int(floor(location.x / cell_size)), int(floor(location.y / cell_size)));
+}
@@ -0,0 +1,80 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "Geometry.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <limits>
+
+/* Spatial_grid
+A Spatial_grid is an index of the locations of objects for answering proximity questions
+without looking at every location. The plane is divided into square cells of a fixed size,
+and each cell holds the IDs and locations of the entries inside it. Entries are added,
+moved, and removed one at a time, so the grid can be kept up to date incrementally.
+The IDs are the small integers that the Model gives object names, so the cell of each
+entry is kept in an array indexed by ID, and the names are looked up only to break ties.
+
+find_in_radius returns the entries within a distance of a point, and find_nearest
+returns the entries closest to a point, nearest first. Distances are computed with
+cartesian_distance, and ties in distance go to the entry whose name comes first.
+*/
+
+class Spatial_grid {
+public:
+    struct Entry {
+        int id;
+        Point location;
+    };
+    // returns the name of an ID
+    typedef const std::string& (*Name_of_id)(int id);
+
+    // cell_size_ is the width of each square cell; name_of_id_ gives the names of the IDs
+    Spatial_grid(double cell_size_, Name_of_id name_of_id_);
+
+    // add the entry, or move it if the ID is already present
+    void update(int id, Point location);
+    // remove the entry; no error if the ID is not present
+    void remove(int id);
+    void clear();
+
+    // return all entries whose distance from center is less than or equal to radius,
+    // in no particular order; the cost is limited by the number of entries, however
+    // large the radius
+    std::vector<Entry> find_in_radius(Point center, double radius) const;
+    // call visit on each of those entries, without copying them
+    void for_each_in_radius(Point center, double radius, const std::function<void(const Entry&)>& visit) const;
+
+    // return up to k entries that are accepted by the supplied function (all are
+    // accepted if it is empty) and whose distance from center is less than or equal to
+    // max_distance, nearest to center first; the search stops at max_distance
+    std::vector<Entry> find_nearest(Point center, int k,
+            const std::function<bool(const Entry&)>& accept = nullptr,
+            double max_distance = std::numeric_limits<double>::infinity()) const;
+
+private:
+    typedef std::pair<int, int> Cell;
+    struct Cell_hash {
+        size_t operator()(const Cell& cell) const
+        {
+            unsigned long long key = static_cast<unsigned>(cell.first);
+            return std::hash<unsigned long long>()((key << 32) | static_cast<unsigned>(cell.second));
+        }
+    };
+
+    double cell_size;
+    Name_of_id name_of_id;
+    std::unordered_map<Cell, std::vector<Entry>, Cell_hash> cells;
+    // the cell of each ID, and whether the ID is present, indexed by ID
+    std::vector<Cell> cell_of_id;
+    std::vector<bool> id_present;
+    // smallest and largest cell coordinates ever used, which limit a nearest search
+    int min_cx, min_cy, max_cx, max_cy;
+
+    Cell get_cell(Point location) const;
+    // return the cell coordinate of the coordinate, limited to [low, high]
+    int get_used_coordinate(double coordinate, int low, int high) const;
+};
+
+#endif
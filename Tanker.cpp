@@ -1,5 +1,7 @@
 #include "Tanker.h"
 #include "Island.h"
+#include "Snapshot.h"
+#include "Profiler.h"
 #include <iostream>
 #include <cassert>
 
@@ -20,13 +22,13 @@ Tanker::Tanker(const std::string &name_, Point position_) :
         cargo(TANKER_INIT_CARGO), cargo_capacity(TANKER_CARGO_CAPACITY),
         tanker_state(State_tanker::NO_CARGO_DEST)
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Tanker " << get_name() << " constructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Tanker " << get_name() << " constructed" << '\n';
 }
 
 // output destructor message
 Tanker::~Tanker()
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Tanker " << get_name() << " destructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Tanker " << get_name() << " destructed" << '\n';
 }
 
 // This class overrides these Ship functions so that it can check if this Tanker has assigned cargo destinations.
@@ -53,7 +55,7 @@ void Tanker::set_load_destination(shared_ptr<Island> dest)
     if (tanker_state != State_tanker::NO_CARGO_DEST) throw Error(TANKER_HAS_DEST_MSG);
     if (unload_dest == dest) throw Error(CARGO_DEST_SAME_MSG);
     load_dest = dest;
-    cout << get_name() << " will load at " << dest->get_name() << endl;
+    cout << get_name() << " will load at " << dest->get_name() << '\n';
     if (unload_dest) start_cycle();
 }
 
@@ -63,10 +65,25 @@ void Tanker::set_unload_destination(shared_ptr<Island> dest)
     if (tanker_state != State_tanker::NO_CARGO_DEST) throw Error(TANKER_HAS_DEST_MSG);
     if (load_dest == dest) throw Error(CARGO_DEST_SAME_MSG);
     unload_dest = dest;
-    cout << get_name() << " will unload at " << dest->get_name() << endl;
+    cout << get_name() << " will unload at " << dest->get_name() << '\n';
     if (load_dest) start_cycle();
 }
 
+// Set both cargo destinations at once, replacing any that are set, and start the cargo cycle;
+// nothing changes if they are the ones already set.
+// if they are the same, throw Error("Load and unload cargo destinations are the same!")
+void Tanker::set_cargo_destinations(shared_ptr<Island> load, shared_ptr<Island> unload)
+{
+    assert(load && unload);
+    if (load == unload) throw Error(CARGO_DEST_SAME_MSG);
+    if (load == load_dest && unload == unload_dest) return;
+    load_dest = load;
+    unload_dest = unload;
+    cout << get_name() << " will load at " << load->get_name() << '\n';
+    cout << get_name() << " will unload at " << unload->get_name() << '\n';
+    start_cycle();
+}
+
 // when told to stop, clear the cargo destinations and stop
 void Tanker::stop()
 {
@@ -76,6 +93,7 @@ void Tanker::stop()
 
 void Tanker::update()
 {
+    PROFILE_SCOPE(PROFILE_TANKER_UPDATE);
     Ship::update();
     if (!can_move())
     {
@@ -107,7 +125,7 @@ void Tanker::update()
                 return;
             }
             cargo += load_dest->provide_fuel(cargo_needed);
-            cout << get_name() << " now has " << cargo << " of cargo" << endl;
+            cout << get_name() << " now has " << cargo << " of cargo" << '\n';
             return;
         case State_tanker::UNLOADING:
             if (cargo == 0)
@@ -122,6 +140,26 @@ void Tanker::update()
     }
 }
 
+// a Tanker has an event every hour while loading or unloading,
+// or when it stops at the end of a leg of its cycle
+int Tanker::get_next_event_delay() const
+{
+    if (!can_move()) return tanker_state == State_tanker::NO_CARGO_DEST ? NO_EVENT_DELAY : 1;
+    switch(tanker_state)
+    {
+        case State_tanker::LOADING:
+        case State_tanker::UNLOADING:
+            return 1;
+        case State_tanker::MOVING_TO_LOAD:
+        case State_tanker::MOVING_TO_UNLOAD:
+            if (!is_moving()) return 1;
+            break;
+        case State_tanker::NO_CARGO_DEST:
+            break;
+    }
+    return Ship::get_next_event_delay();
+}
+
 void Tanker::describe() const
 {
     cout << "\nTanker ";
@@ -130,23 +168,43 @@ void Tanker::describe() const
     switch(tanker_state)
     {
         case State_tanker::NO_CARGO_DEST:
-            cout << ", no cargo destinations" << endl;
+            cout << ", no cargo destinations" << '\n';
             return;
         case State_tanker::LOADING:
-            cout << ", loading" << endl;
+            cout << ", loading" << '\n';
             return;
         case State_tanker::UNLOADING:
-            cout << ", unloading" << endl;
+            cout << ", unloading" << '\n';
             return;
         case State_tanker::MOVING_TO_LOAD:
-            cout << ", moving to loading destination" << endl;
+            cout << ", moving to loading destination" << '\n';
             return;
         case State_tanker::MOVING_TO_UNLOAD:
-            cout << ", moving to unloading destination" << endl;
+            cout << ", moving to unloading destination" << '\n';
             return;
     }
 }
 
+void Tanker::save_state(Snapshot_writer& writer) const
+{
+    Ship::save_state(writer);
+    writer.write_string(load_dest ? load_dest->get_name() : "");
+    writer.write_string(unload_dest ? unload_dest->get_name() : "");
+    writer.write_double(cargo);
+    writer.write_int(static_cast<int>(tanker_state));
+}
+void Tanker::restore_state(Snapshot_reader& reader)
+{
+    Ship::restore_state(reader);
+    Model* model = Model::get_Instance();
+    string load_dest_name = reader.read_string();
+    load_dest = load_dest_name.empty() ? nullptr : model->get_island_ptr(load_dest_name);
+    string unload_dest_name = reader.read_string();
+    unload_dest = unload_dest_name.empty() ? nullptr : model->get_island_ptr(unload_dest_name);
+    cargo = reader.read_double();
+    tanker_state = static_cast<State_tanker>(reader.read_enum(int(State_tanker::MOVING_TO_LOAD) + 1));
+}
+
 // Starts the tanker's cargo cycle
 void Tanker::start_cycle()
 {
@@ -198,5 +256,5 @@ void Tanker::end_cycle()
     load_dest.reset();
     unload_dest.reset();
     tanker_state = State_tanker::NO_CARGO_DEST;
-    cout << get_name() << " now has no cargo destinations" << endl;
+    cout << get_name() << " now has no cargo destinations" << '\n';
 }
\ No newline at end of file
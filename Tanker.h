@@ -43,13 +43,35 @@ public:
 
 	void set_unload_destination(std::shared_ptr<Island>) override;
 
+	// Set both cargo destinations at once, replacing any that are set, and start the cargo cycle;
+	// nothing changes if they are the ones already set.
+	// if they are the same, throw Error("Load and unload cargo destinations are the same!")
+	void set_cargo_destinations(std::shared_ptr<Island> load, std::shared_ptr<Island> unload);
+
+	double get_cargo_capacity() const
+		{return cargo_capacity;}
+
+	// return true if the tanker has both cargo destinations and is working its cargo cycle
+	bool has_cargo_destinations() const
+		{return tanker_state != State_tanker::NO_CARGO_DEST;}
+
 	// when told to stop, clear the cargo destinations and stop
 	void stop() override;
 
 	void update() override;
 
+	// a Tanker has an event every hour while loading or unloading,
+	// or when it stops at the end of a leg of its cycle
+	int get_next_event_delay() const override;
+
 	void describe() const override;
 
+	std::string get_type_name() const override
+		{return "Tanker";}
+
+	void save_state(Snapshot_writer& writer) const override;
+	void restore_state(Snapshot_reader& reader) override;
+
 private:
 	std::shared_ptr<Island> load_dest;			// Loading destination
 	std::shared_ptr<Island> unload_dest;		// Unloading destination
@@ -0,0 +1,142 @@
+#include "Telemetry.h"
+#include "Utility.h"
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+const char TELEMETRY_MAGIC[8] = {'P', '5', 'T', 'E', 'L', 'E', 'M', '\0'};
+
+static_assert(sizeof(Telemetry_record) == 48, "Telemetry records must have no padding");
+
+// create the file and start the writer thread
+View_telemetry::View_telemetry(const string& filename) : View(),
+    file(filename, ios::binary | ios::trunc), writing_full(false), stopping(false), write_failed(false)
+{
+    if (!file) throw Error("Could not open telemetry file!");
+    uint32_t header[2] = {TELEMETRY_VERSION, uint32_t(sizeof(Telemetry_record))};
+    file.write(TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    if (!file) throw Error("Could not open telemetry file!");
+    writer = thread(&View_telemetry::writer_loop, this);
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_telemetry constructed" << '\n';
+}
+
+// write the remaining records and stop the writer thread, if not already closed;
+// a failure cannot be reported from here
+View_telemetry::~View_telemetry()
+{
+    finish();
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_telemetry destructed" << '\n';
+}
+
+// save the supplied information, and note that the ship changed in this tick
+void View_telemetry::update_location_ship(int id, Point location)
+{
+    Ship_state& state = change_ship_state(id);
+    state.location = location;
+    state.gone = false;
+}
+void View_telemetry::update_course_and_speed(int id, double course, double speed)
+{
+    Ship_state& state = change_ship_state(id);
+    state.course = course;
+    state.speed = speed;
+}
+void View_telemetry::update_fuel(int id, double fuel)
+{
+    change_ship_state(id).fuel = fuel;
+}
+void View_telemetry::update_remove_ship(int id)
+{
+    change_ship_state(id).gone = true;
+}
+
+// add the records of the ships that changed, in the order of their first change,
+// and pass them to the writer thread if it is idle
+void View_telemetry::end_tick(int time)
+{
+    for (int id : changed_ids)
+    {
+        Ship_state& state = ship_states[id];
+        state.changed = false;
+        double x = state.gone ? numeric_limits<double>::quiet_NaN() : state.location.x;
+        double y = state.gone ? numeric_limits<double>::quiet_NaN() : state.location.y;
+        filling.push_back(Telemetry_record{time, id, x, y, state.course, state.speed, state.fuel});
+    }
+    changed_ids.clear();
+    hand_over();
+}
+
+// write the remaining records, stop the writer thread, and close the file
+void View_telemetry::close()
+{
+    if (!finish()) throw Error("Could not write telemetry file!");
+}
+
+// return the state of the ship, making room for it if needed, and note that it changed
+View_telemetry::Ship_state& View_telemetry::change_ship_state(int id)
+{
+    if (id >= int(ship_states.size())) ship_states.resize(id + 1);
+    Ship_state& state = ship_states[id];
+    if (!state.changed)
+    {
+        state.changed = true;
+        changed_ids.push_back(id);
+    }
+    return state;
+}
+
+// give the filled buffer to the writer thread, unless it is still writing the other one;
+// the buffers are swapped, so each keeps its memory for the next time it is filled
+void View_telemetry::hand_over()
+{
+    if (filling.empty()) return;
+    {
+        lock_guard<mutex> lock(mtx);
+        if (writing_full) return;
+        swap(filling, writing);
+        writing_full = true;
+    }
+    buffer_ready.notify_one();
+}
+
+// wait for the writer thread to finish its buffer, give it the rest of the records, and
+// let it stop once it has written them; return false if any write failed
+bool View_telemetry::finish()
+{
+    if (!writer.joinable()) return !write_failed;
+    {
+        unique_lock<mutex> lock(mtx);
+        buffer_written.wait(lock, [this]{return !writing_full;});
+        swap(filling, writing);
+        writing_full = !writing.empty();
+        stopping = true;
+    }
+    buffer_ready.notify_one();
+    writer.join();
+    file.close();
+    if (!file) write_failed = true;
+    return !write_failed;
+}
+
+// the body of the writer thread: write each buffer handed over, flushing it so that
+// a reader of the file sees whole ticks, until told to stop with nothing left
+void View_telemetry::writer_loop()
+{
+    unique_lock<mutex> lock(mtx);
+    while (true)
+    {
+        buffer_ready.wait(lock, [this]{return writing_full || stopping;});
+        if (!writing_full) return;
+        lock.unlock();
+        file.write(reinterpret_cast<const char*>(writing.data()), writing.size() * sizeof(Telemetry_record));
+        file.flush();
+        bool failed = !file;
+        writing.clear();
+        lock.lock();
+        if (failed) write_failed = true;
+        writing_full = false;
+        buffer_written.notify_one();
+    }
+}
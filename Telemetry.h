@@ -0,0 +1,108 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "View.h"
+#include "Geometry.h"
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Telemetry log
+A telemetry log records the state of the ships as the simulation runs, for analysis by
+other programs. It starts with a 16-byte header - the 8 bytes "P5TELEM" and a zero byte,
+then the format version and the size of a record as 32-bit unsigned integers - and is
+followed by fixed-width records, so a reader can map the file into memory and use it as
+an array of Telemetry_record. Numbers are in the machine's own binary representation.
+
+At the end of each tick, there is a record for each ship whose location, course and
+speed, or fuel changed in it, holding the ship's whole state. A ship that is gone has a
+record whose x and y are NaN. The ship's name is available from Model::get_name_of_id.
+*/
+
+// the current version of the telemetry log format
+const uint32_t TELEMETRY_VERSION = 1;
+
+struct Telemetry_record {
+    int32_t tick;
+    int32_t id;
+    double x;
+    double y;
+    double course;
+    double speed;
+    double fuel;
+};
+
+/* View_telemetry
+A View_telemetry is a View that is refreshed at the end of every tick and appends the
+records of the tick to a telemetry log. The records are collected in one buffer while a
+background thread writes the other one to the file; at the end of a tick, the buffers
+are swapped if the thread is done with its buffer, and otherwise the records are kept
+until a later tick, so the simulation never waits for the disk.
+*/
+class View_telemetry : public View {
+public:
+    // create the file and start the writer thread
+    // will throw Error("Could not open telemetry file!") if the file cannot be created
+    View_telemetry(const std::string& filename);
+    // write the remaining records and stop the writer thread, if not already closed
+    ~View_telemetry();
+
+    // save the supplied information, and note that the ship changed in this tick
+    void update_location_ship(int id, Point location) override;
+    void update_course_and_speed(int id, double course, double speed) override;
+    void update_fuel(int id, double fuel) override;
+    void update_remove_ship(int id) override;
+
+    bool is_refreshed_every_tick() const override
+        {return true;}
+    // add the records of the ships that changed, and pass them to the writer thread if it is idle
+    void end_tick(int time) override;
+
+    // there is nothing to draw; the records are written at the end of each tick
+    void draw() override {}
+
+    // write the remaining records, stop the writer thread, and close the file
+    // will throw Error("Could not write telemetry file!") if any records could not be written
+    void close();
+
+    // disallow copy/move construction or assignment
+    View_telemetry(const View_telemetry&) = delete;
+    View_telemetry& operator=(const View_telemetry&) = delete;
+
+private:
+    struct Ship_state {
+        Point location;
+        double course = 0., speed = 0., fuel = 0.;
+        bool gone = false;
+        bool changed = false;
+    };
+    std::vector<Ship_state> ship_states;    // indexed by object ID
+    std::vector<int> changed_ids;           // the ships changed in this tick
+
+    std::ofstream file;
+    std::vector<Telemetry_record> filling;  // used only by the simulation
+    std::vector<Telemetry_record> writing;  // used only by the writer thread while writing_full
+    std::thread writer;
+
+    std::mutex mtx;
+    std::condition_variable buffer_ready;
+    std::condition_variable buffer_written;
+    bool writing_full;
+    bool stopping;
+    bool write_failed;
+
+    // return the state of the ship, making room for it if needed, and note that it changed
+    Ship_state& change_ship_state(int id);
+    // give the filled buffer to the writer thread, unless it is still writing
+    void hand_over();
+    // write the remaining records and stop the writer thread; return false if any write failed
+    bool finish();
+    // the body of the writer thread
+    void writer_loop();
+};
+
+#endif
@@ -0,0 +1,310 @@
+#include "Tour_planner.h"
+#include <algorithm>
+#include <cassert>
+#include <deque>
+
+using namespace std;
+
+// how many nearest neighbours of each point the moves consider
+const int TOUR_NEIGHBOUR_COUNT = 8;
+// the longest run of points an Or-opt move will move
+const int TOUR_MAX_SEGMENT_LENGTH = 3;
+// a move must shorten the tour by more than this to be made
+const double TOUR_MIN_GAIN = 1e-9;
+
+/* Tour
+A Tour is the order in which the points are visited, kept as an array of point indexes
+with the position of each point in the array, so that the points before and after any
+point can be found directly.
+*/
+class Tour {
+public:
+    Tour(const vector<Point>& points_, const vector<int>& order_);
+
+    // improve the tour with 2-opt and Or-opt moves until there are none left
+    void improve();
+
+    // return the points in tour order, starting with start
+    vector<int> get_order(int start) const;
+
+private:
+    const vector<Point>& points;
+    int n;
+    vector<int> order;
+    vector<int> position;
+    vector<int> neighbours;     // TOUR_NEIGHBOUR_COUNT per point, nearest first
+    int neighbour_count;
+    deque<int> to_check;        // points whose surroundings have changed
+    vector<bool> queued;
+
+    double distance(int first, int second) const
+        {return cartesian_distance(points[first], points[second]);}
+    int next(int point) const
+        {return order[position[point] + 1 == n ? 0 : position[point] + 1];}
+    int prev(int point) const
+        {return order[position[point] == 0 ? n - 1 : position[point] - 1];}
+
+    void find_neighbours();
+    void queue_point(int point);
+    bool try_2opt(int point);
+    bool try_or_opt(int point);
+    void reverse(int first_position, int last_position);
+    void move_segment(int first, int last, int at, int other, bool last_next_to_at);
+};
+
+// find the nearest neighbours of every point by sweeping outward along the points
+// sorted by x, stopping in each direction once x alone is too far to improve on the list
+void Tour::find_neighbours()
+{
+    vector<int> by_x(n);
+    for (int i = 0; i < n; i++) by_x[i] = i;
+    sort(by_x.begin(), by_x.end(), [this](int first, int second){return points[first].x < points[second].x;});
+    vector<int> rank(n);
+    for (int i = 0; i < n; i++) rank[by_x[i]] = i;
+
+    neighbours.resize(n * neighbour_count);
+    vector<pair<double, int>> best;
+    best.reserve(neighbour_count + 1);
+    for (int point = 0; point < n; point++)
+    {
+        best.clear();
+        // consider the candidate, keeping best sorted and no longer than neighbour_count
+        auto consider = [this, point, &best](int candidate)
+        {
+            double dx = points[candidate].x - points[point].x;
+            double dy = points[candidate].y - points[point].y;
+            pair<double, int> entry(dx * dx + dy * dy, candidate);
+            if (int(best.size()) == neighbour_count && !(entry < best.back())) return;
+            best.insert(upper_bound(best.begin(), best.end(), entry), entry);
+            if (int(best.size()) > neighbour_count) best.pop_back();
+        };
+        // return true if a candidate that far in x cannot be one of the nearest
+        auto too_far = [this, point, &best](int candidate)
+        {
+            double dx = points[candidate].x - points[point].x;
+            return int(best.size()) == neighbour_count && dx * dx > best.back().first;
+        };
+        for (int i = rank[point] - 1; i >= 0 && !too_far(by_x[i]); i--) consider(by_x[i]);
+        for (int i = rank[point] + 1; i < n && !too_far(by_x[i]); i++) consider(by_x[i]);
+        for (int i = 0; i < neighbour_count; i++) neighbours[point * neighbour_count + i] = best[i].second;
+    }
+}
+
+Tour::Tour(const vector<Point>& points_, const vector<int>& order_) :
+    points(points_), n(int(points_.size())), order(order_), position(n),
+    neighbour_count(min(TOUR_NEIGHBOUR_COUNT, n - 1)), queued(n, false)
+{
+    for (int i = 0; i < n; i++) position[order[i]] = i;
+    find_neighbours();
+}
+
+void Tour::queue_point(int point)
+{
+    if (queued[point]) return;
+    queued[point] = true;
+    to_check.push_back(point);
+}
+
+// improve the tour with 2-opt and Or-opt moves until there are none left
+void Tour::improve()
+{
+    // moves need at least two edges that do not touch each other
+    if (n < 4) return;
+    for (int point : order) queue_point(point);
+    while (!to_check.empty())
+    {
+        int point = to_check.front();
+        to_check.pop_front();
+        queued[point] = false;
+        if (try_2opt(point) || try_or_opt(point)) queue_point(point);
+    }
+}
+
+// replace the edge from the point to the next or previous point and another edge by
+// two shorter ones, one of which joins the point to one of its neighbours
+bool Tour::try_2opt(int point)
+{
+    for (bool forward : {true, false})
+    {
+        int point_next = forward ? next(point) : prev(point);
+        double removed_length = distance(point, point_next);
+        for (int i = 0; i < neighbour_count; i++)
+        {
+            int other = neighbours[point * neighbour_count + i];
+            double partial_gain = removed_length - distance(point, other);
+            // the neighbours are in order of distance, so no later one can do better
+            if (partial_gain <= TOUR_MIN_GAIN) break;
+            int other_next = forward ? next(other) : prev(other);
+            if (other == point_next || other_next == point) continue;
+            double gain = partial_gain + distance(other, other_next) - distance(point_next, other_next);
+            if (gain <= TOUR_MIN_GAIN) continue;
+            // join point to other and point_next to other_next by reversing the path between them
+            if (forward) reverse(position[point_next], position[other]);
+            else reverse(position[point], position[other_next]);
+            queue_point(point_next);
+            queue_point(other);
+            queue_point(other_next);
+            return true;
+        }
+    }
+    return false;
+}
+
+// move the run of points that starts with the point to between one of the neighbours
+// of its ends and the point next to that neighbour, either way around
+bool Tour::try_or_opt(int point)
+{
+    int last = point;
+    for (int length = 1; length <= TOUR_MAX_SEGMENT_LENGTH && length + 3 <= n; length++)
+    {
+        if (length > 1) last = next(last);
+        int before = prev(point);
+        int after = next(last);
+        double removal_gain = distance(before, point) + distance(last, after) - distance(before, after);
+        if (removal_gain <= TOUR_MIN_GAIN) continue;
+        // return true if the point is in the run being moved
+        auto in_segment = [this, point, length](int candidate)
+        {
+            int offset = position[candidate] - position[point];
+            if (offset < 0) offset += n;
+            return offset < length;
+        };
+        for (int end : {point, last})
+        {
+            int other_end = end == point ? last : point;
+            for (int i = 0; i < neighbour_count; i++)
+            {
+                int at = neighbours[end * neighbour_count + i];
+                if (distance(end, at) >= removal_gain) break;
+                if (in_segment(at)) continue;
+                for (int at_other : {next(at), prev(at)})
+                {
+                    if (in_segment(at_other)) continue;
+                    double added_length = distance(at, end) + distance(other_end, at_other) - distance(at, at_other);
+                    if (removal_gain - added_length <= TOUR_MIN_GAIN) continue;
+                    move_segment(point, last, at, at_other, end == last);
+                    queue_point(before);
+                    queue_point(after);
+                    queue_point(at);
+                    queue_point(at_other);
+                    queue_point(last);
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// reverse the path between the positions, going forward from the first; the other side of
+// the tour is reversed instead if it is shorter, which leaves the same tour
+void Tour::reverse(int first_position, int last_position)
+{
+    int length = last_position - first_position;
+    if (length < 0) length += n;
+    ++length;
+    if (2 * length > n)
+    {
+        first_position = last_position + 1 == n ? 0 : last_position + 1;
+        last_position = first_position + n - length - 1;
+        if (last_position >= n) last_position -= n;
+        length = n - length;
+    }
+    for (int i = 0; i < length / 2; i++)
+    {
+        int& first = order[first_position];
+        int& second = order[last_position];
+        swap(first, second);
+        position[first] = first_position;
+        position[second] = last_position;
+        if (++first_position == n) first_position = 0;
+        if (--last_position < 0) last_position = n - 1;
+    }
+}
+
+// move the run of points from first forward to last so that it is between at and other,
+// which are next to each other, with last next to at if last_next_to_at, and first otherwise
+void Tour::move_segment(int first, int last, int at, int other, bool last_next_to_at)
+{
+    vector<int> segment;
+    for (int point = first; ; point = next(point))
+    {
+        segment.push_back(point);
+        if (point == last) break;
+    }
+    vector<int> new_order;
+    new_order.reserve(n);
+    // go once around the rest of the tour, starting after the run
+    for (int point = next(last); point != first; point = next(point))
+    {
+        new_order.push_back(point);
+        int point_next = next(point);
+        if (!((point == at && point_next == other) || (point == other && point_next == at))) continue;
+        // the run is entered from the point, so its end next to at goes first if the point is at
+        bool last_first = (point == at) == last_next_to_at;
+        if (last_first) new_order.insert(new_order.end(), segment.rbegin(), segment.rend());
+        else new_order.insert(new_order.end(), segment.begin(), segment.end());
+    }
+    assert(int(new_order.size()) == n);
+    order.swap(new_order);
+    for (int i = 0; i < n; i++) position[order[i]] = i;
+}
+
+// return the points in tour order, starting with start
+vector<int> Tour::get_order(int start) const
+{
+    vector<int> result(order.begin() + position[start], order.end());
+    result.insert(result.end(), order.begin(), order.begin() + position[start]);
+    return result;
+}
+
+// return the order of the tour that always goes next to the nearest point not yet visited
+static vector<int> nearest_neighbour_tour(const vector<Point>& points, int start)
+{
+    int n = int(points.size());
+    // the unvisited points, with the position of each in the list so it can be removed in place
+    vector<int> unvisited(n);
+    vector<int> unvisited_position(n);
+    for (int i = 0; i < n; i++) unvisited[i] = unvisited_position[i] = i;
+    auto visit = [&unvisited, &unvisited_position](int point)
+    {
+        int moved = unvisited.back();
+        unvisited[unvisited_position[point]] = moved;
+        unvisited_position[moved] = unvisited_position[point];
+        unvisited.pop_back();
+        unvisited_position[point] = -1;
+    };
+    vector<int> order;
+    order.reserve(n);
+    int current = start;
+    visit(current);
+    order.push_back(current);
+    while (!unvisited.empty())
+    {
+        int nearest = unvisited.front();
+        double nearest_distance = cartesian_distance(points[current], points[nearest]);
+        for (int point : unvisited)
+        {
+            double point_distance = cartesian_distance(points[current], points[point]);
+            if (point_distance < nearest_distance)
+            {
+                nearest = point;
+                nearest_distance = point_distance;
+            }
+        }
+        current = nearest;
+        visit(current);
+        order.push_back(current);
+    }
+    return order;
+}
+
+// return the indexes of the points in the order of a short closed tour beginning with
+// the start index; the tour returns to the start after the last index
+vector<int> plan_tour(const vector<Point>& points, int start)
+{
+    assert(start >= 0 && start < int(points.size()));
+    Tour tour(points, nearest_neighbour_tour(points, start));
+    tour.improve();
+    return tour.get_order(start);
+}
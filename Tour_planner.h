@@ -0,0 +1,24 @@
+#ifndef TOUR_PLANNER_H
+#define TOUR_PLANNER_H
+
+#include "Geometry.h"
+#include <vector>
+
+/* Tour planning
+plan_tour finds a short closed tour through a set of points, for a ship that must visit
+every one of them and come back to where it started. It is a heuristic, not an exact
+solution: the tour is built by always going to the nearest point not yet visited, and
+is then improved by 2-opt moves, which replace two edges by two shorter ones, and by
+Or-opt moves, which move a run of up to three points to a better place in the tour,
+until no such move shortens it.
+
+To keep planning fast for thousands of points, the moves only consider joining a point
+to one of its nearest neighbours, and a point is only looked at again once the tour
+next to it has changed.
+*/
+
+// return the indexes of the points in the order of a short closed tour beginning with
+// the start index; the tour returns to the start after the last index
+std::vector<int> plan_tour(const std::vector<Point>& points, int start);
+
+#endif
@@ -8,25 +8,26 @@ using namespace std;
 
 /* Public Function Definitions */
 
-Track_base::Track_base() : altitude(0.)
+Track_base::Track_base() : course_unit(compass_unit_vector(0.)), altitude(0.)
 {
-	if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) std::cout << "Track_base constructed" << std::endl;
+	if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) std::cout << "Track_base constructed" << '\n';
 }
 
-Track_base::Track_base(Point in_position) : position(in_position), altitude(0.)
+Track_base::Track_base(Point in_position) : position(in_position), course_unit(compass_unit_vector(0.)), altitude(0.)
 {
-	if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) std::cout << "Track_base constructed" << std::endl;
+	if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) std::cout << "Track_base constructed" << '\n';
 }
 
 Track_base::Track_base(Point in_position, Course_speed in_course_speed, double in_altitude) :
-		position(in_position), course_speed(in_course_speed), altitude(in_altitude)
+		position(in_position), course_speed(in_course_speed),
+		course_unit(compass_unit_vector(in_course_speed.course)), altitude(in_altitude)
 {
-	if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) std::cout << "Track_base constructed" << std::endl;
+	if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) std::cout << "Track_base constructed" << '\n';
 }
 
 Track_base::~Track_base()
 {
-	if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) std::cout << "Track_base destructed" << std::endl;
+	if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) std::cout << "Track_base destructed" << '\n';
 }
 
 
@@ -74,9 +75,9 @@ bool Track_base::is_inbound_toward(const Track_base * track_ptr) const
 	return result;
 }
 
-// update the position of this object
+// update the position of this object; the distance moved along the cached unit vector
+// gives the same result as adding the Compass_vector of the course and distance
 void Track_base::update_position(double time_increment)
 {
-	position = position + (course_speed * time_increment);
+	position = position + course_unit * (course_speed.speed * time_increment);
 }
-
@@ -38,9 +38,9 @@ public:
 	void set_position(Point in_position)
 		{position = in_position;}
 	void set_course_speed(const Course_speed& in_course_speed)
-		{course_speed = in_course_speed;}
+		{course_speed = in_course_speed; course_unit = compass_unit_vector(course_speed.course);}
 	void set_course (double in_course)
-		{course_speed.course = in_course;}
+		{course_speed.course = in_course; course_unit = compass_unit_vector(in_course);}
 	void set_speed (double in_speed)
 		{course_speed.speed = in_speed;}
 	void set_altitude (double in_altitude)
@@ -70,6 +70,7 @@ public:
 private:
 	Point position;				// Current location
 	Course_speed course_speed;			// Current course & speed
+	Cartesian_vector course_unit;		// unit vector along the current course
 	double altitude;					// Current altitude
 };
 
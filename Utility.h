@@ -18,5 +18,7 @@ const bool SHOW_CONSTRUCTOR_DESTRUCTOR_MSG = false;
 const double REFUEL_MIN = .005;
 // length used by model and view to represent names
 const int SHORTEN_NAME_LENGTH = 2;
+// event delay of an object whose updates make only steady progress
+const int NO_EVENT_DELAY = 1000000000;
 
 #endif
@@ -6,10 +6,10 @@ using namespace std;
 
 View::View()
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View constructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View constructed" << '\n';
 }
 
 View::~View()
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View destructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View destructed" << '\n';
 }
\ No newline at end of file
@@ -3,6 +3,9 @@
 
 #include "Geometry.h"
 #include <string>
+#include <vector>
+
+struct Collision_risk;
 
 /* *** View class ***
 Represents the interface for a view to be displayed to the user
@@ -13,15 +16,25 @@ class View {
 public:
 	virtual ~View();	// outputs destructor message
 
-	// Save the supplied name and information for future use in a draw() call
-	// If the name is already present,the new location replaces the previous one.
-	virtual void update_location_ship(const std::string& name, Point location) {}
-	virtual void update_location_island(const std::string& name, Point location) {}
-	virtual void update_course_and_speed(const std::string& name, double course, double speed) {}
-	virtual void update_fuel(const std::string& name, double fuel) {}
-
-	// Remove the name and its location; no error if the name is not present.
-	virtual void update_remove_ship(const std::string& name) {}
+	// Save the supplied information about the object with the supplied ID for future use in a draw() call.
+	// If the object is already present, the new information replaces the previous one.
+	// The object's name is available from Model::get_name_of_id.
+	virtual void update_location_ship(int id, Point location) {}
+	virtual void update_location_island(int id, Point location) {}
+	virtual void update_course_and_speed(int id, double course, double speed) {}
+	virtual void update_fuel(int id, double fuel) {}
+
+	// Remove the object and its location; no error if the object is not present.
+	virtual void update_remove_ship(int id) {}
+
+	// Save the collision risks found by the Model, which replace the previous ones.
+	virtual void update_collision_risks(const std::vector<Collision_risk>& risks) {}
+
+	// Return true if the view is to be refreshed at the end of every tick, rather than
+	// only before it is drawn.
+	virtual bool is_refreshed_every_tick() const {return false;}
+	// Called for such a view when it has been refreshed at the end of the tick at the supplied time.
+	virtual void end_tick(int time) {}
 
 	// prints out the view
 	virtual void draw() = 0;
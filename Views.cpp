@@ -1,8 +1,11 @@
 #include "Views.h"
+#include "Model.h"
 #include "Navigation.h"
 #include "Utility.h"
+#include "Profiler.h"
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <vector>
 #include <cmath>
 
@@ -12,95 +15,101 @@ const int VIEW_SAIL_FIELD_SIZE = 10;
 
 View_sail::View_sail() : View()
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_sail constructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_sail constructed" << '\n';
 }
 View_sail::~View_sail()
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_sail destructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_sail destructed" << '\n';
 }
 
-void View_sail::update_course_and_speed(const std::string& name, double course, double speed)
+void View_sail::update_course_and_speed(int id, double course, double speed)
 {
-    auto ship_it = ship_map.find(name);
-    if (ship_it == ship_map.end())
-    {
-        Ship_data data;
-        data.set_course_speed(course, speed);
-        ship_map[name] = data;
-    }
-    else
-    {
-        (*ship_it).second.set_course_speed(course, speed);
-    }
+    get_ship_data(id).set_course_speed(course, speed);
 }
-void View_sail::update_fuel(const std::string& name, double fuel)
+void View_sail::update_fuel(int id, double fuel)
 {
-    auto ship_it = ship_map.find(name);
-    if (ship_it == ship_map.end())
-    {
-        Ship_data data;
-        data.set_fuel(fuel);
-        ship_map[name] = data;
-    }
-    else
-    {
-        (*ship_it).second.set_fuel(fuel);
-    }
+    get_ship_data(id).set_fuel(fuel);
+}
+
+// Remove the ship's information; no error if the ship is not present.
+void View_sail::update_remove_ship(int id)
+{
+    if (id < int(ship_data.size())) ship_data[id] = Ship_data();
 }
 
-// Remove the name and its location; no error if the name is not present.
-void View_sail::update_remove_ship(const std::string& name)
+// Save the collision risks, which are listed below the ships
+void View_sail::update_collision_risks(const vector<Collision_risk>& risks)
 {
-    auto ship_it = ship_map.find(name);
-    if (ship_it != ship_map.end()) ship_map.erase(ship_it);
+    collision_risks = risks;
 }
 
 // prints out the current map
 void View_sail::draw()
 {
-    cout << "----- Sailing Data -----" << endl;
+    PROFILE_SCOPE(PROFILE_SAIL_DRAW);
+    cout << "----- Sailing Data -----" << '\n';
     cout.width(VIEW_SAIL_FIELD_SIZE);
     cout << setw(VIEW_SAIL_FIELD_SIZE) << "Ship" << setw(VIEW_SAIL_FIELD_SIZE) << "Fuel" <<
-            setw(VIEW_SAIL_FIELD_SIZE) << "Course" << setw(VIEW_SAIL_FIELD_SIZE) << "Speed" << endl;
-    for (auto&& ship : ship_map)
+            setw(VIEW_SAIL_FIELD_SIZE) << "Course" << setw(VIEW_SAIL_FIELD_SIZE) << "Speed" << '\n';
+    for (int id : Model::get_ids_in_name_order())
+    {
+        if (id >= int(ship_data.size()) || !ship_data[id].is_present()) continue;
+        Ship_data& ship = ship_data[id];
+        cout << setw(VIEW_SAIL_FIELD_SIZE) << Model::get_name_of_id(id) << setw(VIEW_SAIL_FIELD_SIZE) << ship.get_fuel() <<
+                setw(VIEW_SAIL_FIELD_SIZE) << ship.get_course() <<
+                setw(VIEW_SAIL_FIELD_SIZE) << ship.get_speed() << '\n';
+    }
+    for (auto&& risk : collision_risks)
     {
-        cout << setw(VIEW_SAIL_FIELD_SIZE) << ship.first << setw(VIEW_SAIL_FIELD_SIZE) << ship.second.get_fuel() <<
-                setw(VIEW_SAIL_FIELD_SIZE) << ship.second.get_course() <<
-                setw(VIEW_SAIL_FIELD_SIZE) << ship.second.get_speed() << endl;
+        cout << "Collision risk: " << Model::get_name_of_id(risk.ship_id) << " and " << Model::get_name_of_id(risk.other_id) <<
+                ", closest approach " << risk.range << " nm in " << risk.time << " hr" << '\n';
     }
 }
 
 // Discard the saved information - drawing will show only a empty pattern
 void View_sail::clear()
 {
-    ship_map.clear();
+    ship_data.clear();
+    collision_risks.clear();
+}
+
+// return the data of the ship, making room for it if needed
+View_sail::Ship_data& View_sail::get_ship_data(int id)
+{
+    if (id >= int(ship_data.size())) ship_data.resize(id + 1);
+    return ship_data[id];
 }
 
 View_locations::View_locations() : View()
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_locations constructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_locations constructed" << '\n';
 }
 View_locations::~View_locations()
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_locations destructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_locations destructed" << '\n';
 }
 
-// Save the supplied name and information for future use in a draw() call
-// If the name is already present,the new location replaces the previous one.
-void View_locations::update_location_ship(const std::string& name, Point location)
+// Save the supplied information for future use in a draw() call
+// If the object is already present, the new location replaces the previous one.
+void View_locations::update_location_ship(int id, Point location)
 {
-    object_data[name] = location;
+    update_location_island(id, location);
 }
-void View_locations::update_location_island(const std::string& name, Point location)
+void View_locations::update_location_island(int id, Point location)
 {
-    object_data[name] = location;
+    if (id >= int(object_locations.size()))
+    {
+        object_locations.resize(id + 1);
+        object_present.resize(id + 1, 0);
+    }
+    object_locations[id] = location;
+    object_present[id] = 1;
 }
 
-// Remove the name and its location; no error if the name is not present.
-void View_locations::update_remove_ship(const std::string& name)
+// Remove the object and its location; no error if the object is not present.
+void View_locations::update_remove_ship(int id)
 {
-    auto object_it = object_data.find(name);
-    if (object_it != object_data.end()) object_data.erase(object_it);
+    if (id < int(object_present.size())) object_present[id] = 0;
 }
 
 const int VIEW_BRIDGE_MAP_HEIGHT = 3;
@@ -119,37 +128,52 @@ const double VIEW_BRIDGE_MIN_DIST = .005;
 const double VIEW_BRIDGE_FULL = 360;
 const double VIEW_BRIDGE_HALF = 180;
 
-View_bridge::View_bridge(const std::string& name) : View_locations(), target(name), target_sunk(false)
+View_bridge::View_bridge(const std::string& name) :
+        View_locations(), target(name), target_id(Model::intern_name(name)), target_sunk(false), object_grid(VIEW_BRIDGE_MAX_DIST, Model::get_name_of_id)
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_bridge constructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_bridge constructed" << '\n';
 }
 View_bridge::~View_bridge()
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_bridge destructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_bridge destructed" << '\n';
 }
 
-void View_bridge::update_course_and_speed(const std::string& name, double course, double speed)
+void View_bridge::update_location_ship(int id, Point location)
+{
+    // a ship of the target's name can appear again when a snapshot is loaded
+    if (id == target_id) target_sunk = false;
+    View_locations::update_location_ship(id, location);
+    object_grid.update(id, location);
+}
+void View_bridge::update_location_island(int id, Point location)
 {
-    if (name == target)
+    View_locations::update_location_island(id, location);
+    object_grid.update(id, location);
+}
+
+void View_bridge::update_course_and_speed(int id, double course, double speed)
+{
+    if (id == target_id)
     {
         target_course = course;
     }
 }
 
-void View_bridge::update_remove_ship(const std::string& name)
+void View_bridge::update_remove_ship(int id)
 {
-    if (name == target)
+    if (id == target_id)
     {
-        assert(object_data.find(target) != object_data.end());
         target_sunk = true;
-        target_location = object_data[name];
+        target_location = get_location(target_id);
     }
-    View_locations::update_remove_ship(name);
+    View_locations::update_remove_ship(id);
+    object_grid.remove(id);
 }
 
 // prints out the view
 void View_bridge::draw()
 {
+    PROFILE_SCOPE(PROFILE_BRIDGE_DRAW);
     // initialize the bridge map
     vector<vector<string>> bridge_map;
     // a row in the map must start out filled only with VIEW_BRIDGE_NO_OBJECT or VIEW_BRIDGE_UNDERWATER
@@ -162,21 +186,20 @@ void View_bridge::draw()
     // if sunk, display the watery pattern, otherwise build the map
     if (target_sunk)
     {
-        cout << "Bridge view from " << target << " sunk at " << target_location << endl;
+        cout << "Bridge view from " << target << " sunk at " << target_location << '\n';
     }
     else
     {
-        // if not sunk then the object must appear in the object data map
-        assert(object_data.find(target) != object_data.end());
-        cout << "Bridge view from " << target << " position " << object_data[target] << " heading " << target_course << endl;
+        // if not sunk then the object must have a location
+        cout << "Bridge view from " << target << " position " << get_location(target_id) << " heading " << target_course << '\n';
 
-        // build the bridge map
-        for (auto&& object : object_data)
+        // build the bridge map from the objects within sight
+        for (auto&& object : object_grid.find_in_radius(get_location(target_id), VIEW_BRIDGE_MAX_DIST))
         {
             int x;
-            if (get_heading(x, object.second))
+            if (get_heading(x, object.location))
             {
-                if (bridge_map[0][x] == VIEW_BRIDGE_NO_OBJECT) bridge_map[0][x] = object.first.substr(0, SHORTEN_NAME_LENGTH);
+                if (bridge_map[0][x] == VIEW_BRIDGE_NO_OBJECT) bridge_map[0][x] = Model::get_name_of_id(object.id).substr(0, SHORTEN_NAME_LENGTH);
                 else bridge_map[0][x] = VIEW_BRIDGE_MULTIPLE_OBJECT;
             }
         }
@@ -190,7 +213,7 @@ void View_bridge::draw()
         {
             cout << bridge_map[y][x];
         }
-        cout << endl;
+        cout << '\n';
     }
     // save precision
     int old_precision = cout.precision();
@@ -200,14 +223,20 @@ void View_bridge::draw()
     {
         cout << setw(SHORTEN_NAME_LENGTH * VIEW_BRIDGE_LINES_PER_AXIS_LABEL) << (VIEW_BRIDGE_MIN_SHOW + x * VIEW_BRIDGE_SCALE);
     }
-    cout << endl;
+    cout << '\n';
     // restore precision
     cout.precision(old_precision);
 }
 
+void View_bridge::clear()
+{
+    View_locations::clear();
+    object_grid.clear();
+}
+
 bool View_bridge::get_heading(int& x, Point location)
 {
-    Compass_position compass(object_data[target], location);
+    Compass_position compass(get_location(target_id), location);
     if (compass.range < VIEW_BRIDGE_MIN_DIST || compass.range > VIEW_BRIDGE_MAX_DIST) return false;
     double bearing = compass.bearing - target_course;
     if (bearing < -1 * VIEW_BRIDGE_HALF)
@@ -231,76 +260,64 @@ const string VIEW_MAP_NO_OBJECT = ". ";
 const int VIEW_MAP_LINES_PER_AXIS_LABEL = 3;
 const int VIEW_MAP_AXIS_LABEL_MAX = 4;
 
+// the cell of an object that is not on the map
+const int VIEW_MAP_NO_CELL = -1;
+
 // default constructor sets the default size, scale, and origin, outputs constructor message
-View_map::View_map() : View_locations()
+View_map::View_map() : View_locations(), frame_valid(false)
 {
     set_defaults();
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_map constructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_map constructed" << '\n';
 }
 // outputs destructor message
 View_map::~View_map()
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_map destructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "View_map destructed" << '\n';
 }
 
-// prints out the current map
-void View_map::draw()
+// also move the object's mark on the map
+void View_map::update_location_ship(int id, Point location)
 {
-    // save precision
-    int old_precision = cout.precision();
+    View_locations::update_location_ship(id, location);
+    if (frame_valid) place_object(id);
+}
+void View_map::update_location_island(int id, Point location)
+{
+    View_locations::update_location_island(id, location);
+    if (frame_valid) place_object(id);
+}
 
-    vector<vector<string>> map_view;
-    vector<string> objects_out_of_map;
-    // a row in the map must start out filled only with VIEW_MAP_NO_OBJECTs
-    vector<string> initial_row;
-    for (int i = 0; i < size; i++) initial_row.push_back(VIEW_MAP_NO_OBJECT);
-    // fill the map with copies of the initial row
-    for (int i = 0; i < size; i++) map_view.push_back(vector<string>(initial_row));
+void View_map::update_remove_ship(int id)
+{
+    View_locations::update_remove_ship(id);
+    if (frame_valid) place_object(id);
+}
 
-    // generate the map
-    // each object in object_data is a pair where first is the name and second is the Point
-    for (auto&& object : object_data)
-    {
-        int x, y;
-        if (get_subscripts(x, y, object.second))
-        {
-            if (map_view[y][x] == VIEW_MAP_NO_OBJECT) map_view[y][x] = object.first.substr(0, SHORTEN_NAME_LENGTH);
-            else map_view[y][x] = VIEW_MAP_MULTIPLE_OBJECT;
-        } else objects_out_of_map.push_back(object.first);
-    }
+void View_map::clear()
+{
+    View_locations::clear();
+    object_cells.clear();
+    frame_valid = false;
+}
 
-    cout << "Display size: " << size << ", scale: " << scale << ", origin: " << origin << endl;
-    cout.precision(0);
-    if (objects_out_of_map.size() > 0)
-    {
-        for (size_t i = 0; i < objects_out_of_map.size() - 1; i++)
-        {
-            cout << objects_out_of_map[i] << ", ";
-        }
-        cout << objects_out_of_map[objects_out_of_map.size() - 1] << " outside the map" << endl;
-    }
-    // start from max y and iterate through map
-    for (int y = size - 1; y >= 0; y--)
-    {
-        if (y % VIEW_MAP_LINES_PER_AXIS_LABEL == 0)
-        {
-            cout << setw(VIEW_MAP_AXIS_LABEL_MAX) << (origin.y + scale * y) << " ";
-        } else cout << setw(VIEW_MAP_AXIS_LABEL_MAX + 1) << " ";
-        // iterate through the map of this row
-        for (int x = 0; x < size; x++)
-        {
-            cout << map_view[y][x];
-        }
-        cout << endl;
-    }
-    for (int x = 0; x < size; x += VIEW_MAP_LINES_PER_AXIS_LABEL)
+// prints out the current map
+void View_map::draw()
+{
+    PROFILE_SCOPE(PROFILE_MAP_DRAW);
+    if (!frame_valid) rebuild_frame();
+
+    cout << "Display size: " << size << ", scale: " << scale << ", origin: " << origin << '\n';
+    // the objects outside the map, in name order
+    bool any_outside = false;
+    for (int id : Model::get_ids_in_name_order())
     {
-        cout << setw(SHORTEN_NAME_LENGTH * VIEW_MAP_LINES_PER_AXIS_LABEL) << (origin.x + scale * x);
+        if (!is_present(id) || object_cells[id] != VIEW_MAP_NO_CELL) continue;
+        if (any_outside) cout << ", ";
+        cout << Model::get_name_of_id(id);
+        any_outside = true;
     }
-    cout << endl;
-
-    // restore precision
-    cout.precision(old_precision);
+    if (any_outside) cout << " outside the map" << '\n';
+    cout.write(frame.data(), frame.size());
 }
 
 // modify the display parameters
@@ -311,6 +328,7 @@ void View_map::set_size(int size_)
     if (size_ <= 6) throw Error("New map size is too small!");
     if (size_ > 30) throw Error("New map size is too big!");
     size = size_;
+    frame_valid = false;
 }
 
 // If scale is not positive, will throw Error("New map scale must be positive!");
@@ -318,6 +336,7 @@ void View_map::set_scale(double scale_)
 {
     if (scale_ <= 0) throw Error("New map scale must be positive!");
     scale = scale_;
+    frame_valid = false;
 }
 
 // set the parameters to the default values
@@ -326,6 +345,81 @@ void View_map::set_defaults()
     size = VIEW_MAP_DEFAULT_SIZE;
     scale = VIEW_MAP_DEFAULT_SCALE;
     origin = VIEW_MAP_DEFAULT_ORIGIN;
+    frame_valid = false;
+}
+
+// lay out the frame for the current parameters and mark every object present;
+// the axis labels are formatted like the rest of the output, with no decimal places
+void View_map::rebuild_frame()
+{
+    ostringstream frame_stream;
+    frame_stream.copyfmt(cout);
+    frame_stream.precision(0);
+    row_offsets.assign(size, 0);
+    // start from max y; each row starts with its label, or blanks
+    for (int y = size - 1; y >= 0; y--)
+    {
+        if (y % VIEW_MAP_LINES_PER_AXIS_LABEL == 0)
+        {
+            frame_stream << setw(VIEW_MAP_AXIS_LABEL_MAX) << (origin.y + scale * y) << " ";
+        } else frame_stream << setw(VIEW_MAP_AXIS_LABEL_MAX + 1) << " ";
+        row_offsets[y] = int(frame_stream.tellp());
+        for (int x = 0; x < size; x++)
+        {
+            frame_stream << VIEW_MAP_NO_OBJECT;
+        }
+        frame_stream << '\n';
+    }
+    for (int x = 0; x < size; x += VIEW_MAP_LINES_PER_AXIS_LABEL)
+    {
+        frame_stream << setw(SHORTEN_NAME_LENGTH * VIEW_MAP_LINES_PER_AXIS_LABEL) << (origin.x + scale * x);
+    }
+    frame_stream << '\n';
+    frame = frame_stream.str();
+
+    cell_counts.assign(size * size, 0);
+    cell_id_xors.assign(size * size, 0);
+    object_cells.assign(object_cells.size(), VIEW_MAP_NO_CELL);
+    frame_valid = true;
+    for (int id : Model::get_ids_in_name_order())
+    {
+        if (is_present(id)) place_object(id);
+    }
+}
+
+// move the object to the cell of its current location, or take it off the map
+// if it is not present or outside the map
+void View_map::place_object(int id)
+{
+    if (id >= int(object_cells.size())) object_cells.resize(id + 1, VIEW_MAP_NO_CELL);
+    int new_cell = VIEW_MAP_NO_CELL;
+    int x, y;
+    if (is_present(id) && get_subscripts(x, y, get_location(id))) new_cell = y * size + x;
+    int old_cell = object_cells[id];
+    if (new_cell == old_cell) return;
+    if (old_cell != VIEW_MAP_NO_CELL)
+    {
+        cell_counts[old_cell]--;
+        cell_id_xors[old_cell] ^= id;
+        write_cell(old_cell);
+    }
+    if (new_cell != VIEW_MAP_NO_CELL)
+    {
+        cell_counts[new_cell]++;
+        cell_id_xors[new_cell] ^= id;
+        write_cell(new_cell);
+    }
+    object_cells[id] = new_cell;
+}
+
+// rewrite the frame's characters for the cell
+void View_map::write_cell(int cell)
+{
+    const string* mark = &VIEW_MAP_NO_OBJECT;
+    if (cell_counts[cell] > 1) mark = &VIEW_MAP_MULTIPLE_OBJECT;
+    else if (cell_counts[cell] == 1) mark = &Model::get_name_of_id(cell_id_xors[cell]);
+    int offset = row_offsets[cell / size] + SHORTEN_NAME_LENGTH * (cell % size);
+    frame.replace(offset, SHORTEN_NAME_LENGTH, *mark, 0, SHORTEN_NAME_LENGTH);
 }
 
 // Calculate the cell subscripts corresponding to the supplied location parameter,
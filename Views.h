@@ -2,10 +2,13 @@
 #define VIEWS_H
 
 #include "View.h"
+#include "Model.h"
 #include "Geometry.h"
+#include "Output.h"
+#include "Spatial_grid.h"
 #include <cassert>
 #include <string>
-#include <map>
+#include <vector>
 
 /* sailing view class */
 class View_sail : public View {
@@ -13,12 +16,15 @@ public:
     View_sail();		// outputs constructor message
     ~View_sail();	// outputs destructor message
 
-    // Save the supplied name and information for future use in a draw() call
-    void update_course_and_speed(const std::string& name, double course, double speed) override;
-    void update_fuel(const std::string& name, double fuel) override;
+    // Save the supplied information for future use in a draw() call
+    void update_course_and_speed(int id, double course, double speed) override;
+    void update_fuel(int id, double fuel) override;
 
-    // Remove the name and its location; no error if the name is not present.
-    void update_remove_ship(const std::string& name) override;
+    // Remove the ship's information; no error if the ship is not present.
+    void update_remove_ship(int id) override;
+
+    // Save the collision risks, which are listed below the ships
+    void update_collision_risks(const std::vector<Collision_risk>& risks) override;
 
     // prints out the current map
     void draw() override;
@@ -35,16 +41,19 @@ private:
         double get_course()
         {
             if (course_speed_defined) return course;
+            flush_output();
             assert(false);
         }
         double get_speed()
         {
             if (course_speed_defined) return speed;
+            flush_output();
             assert(false);
         }
         double get_fuel()
         {
             if (fuel_defined) return fuel;
+            flush_output();
             assert(false);
         }
         void set_course_speed(double course_, double speed_)
@@ -58,6 +67,11 @@ private:
             fuel = fuel_;
             fuel_defined = true;
         }
+        // a ship is present once any of its information has been supplied
+        bool is_present() const
+        {
+            return course_speed_defined || fuel_defined;
+        }
     private:
         double course;
         double speed;
@@ -66,31 +80,49 @@ private:
         bool fuel_defined;
     };
 
-    std::map<std::string, Ship_data> ship_map;
+    std::vector<Ship_data> ship_data;   // indexed by object ID
+    std::vector<Collision_risk> collision_risks;
+
+    // return the data of the ship, making room for it if needed
+    Ship_data& get_ship_data(int id);
 };
 
-/* this subclass is used by Views which get their data from a map of object name to location data */
+/* this subclass is used by Views which get their data from an array of object locations indexed by object ID */
 class View_locations : public View {
 public:
     ~View_locations();	// outputs destructor message
 
-    // Save the supplied name and information for future use in a draw() call
-    // If the name is already present,the new location replaces the previous one.
-    void update_location_ship(const std::string& name, Point location) override;
-    void update_location_island(const std::string& name, Point location) override;
+    // Save the supplied information for future use in a draw() call
+    // If the object is already present, the new location replaces the previous one.
+    void update_location_ship(int id, Point location) override;
+    void update_location_island(int id, Point location) override;
 
-    // Remove the name and its location; no error if the name is not present.
-    void update_remove_ship(const std::string& name) override;
+    // Remove the object and its location; no error if the object is not present.
+    void update_remove_ship(int id) override;
 
     // Discard the saved information - drawing will show only a empty pattern
     void clear() override
     {
-        object_data.clear();
+        object_locations.clear();
+        object_present.clear();
     }
 
 protected:
     View_locations();
-    std::map<std::string, Point> object_data;
+
+    bool is_present(int id) const
+    {
+        return id < int(object_present.size()) && object_present[id];
+    }
+    Point get_location(int id) const
+    {
+        assert(is_present(id));
+        return object_locations[id];
+    }
+
+private:
+    std::vector<Point> object_locations;    // indexed by object ID
+    std::vector<char> object_present;
 };
 
 /* bridge view class */
@@ -99,18 +131,27 @@ public:
     View_bridge(const std::string& name);
     ~View_bridge();
 
-    void update_course_and_speed(const std::string& name, double course, double speed) override;
+    // also keep the locations in a spatial index, so that only the objects
+    // within sight of the target need to be examined when drawing
+    void update_location_ship(int id, Point location) override;
+    void update_location_island(int id, Point location) override;
+
+    void update_course_and_speed(int id, double course, double speed) override;
 
-    void update_remove_ship(const std::string& name) override;
+    void update_remove_ship(int id) override;
 
     // prints out the view
     void draw() override;
 
+    void clear() override;
+
 private:
     std::string target;
+    int target_id;
     Point target_location;
     double target_course;
     bool target_sunk;
+    Spatial_grid object_grid;
 
     bool get_heading(int& x, Point location);
 };
@@ -144,9 +185,17 @@ public:
     View_map();
     ~View_map();	// outputs destructor message
 
+    // also move the object's mark on the map, rewriting only the cells involved
+    void update_location_ship(int id, Point location) override;
+    void update_location_island(int id, Point location) override;
+
+    void update_remove_ship(int id) override;
+
     // prints out the current map
     void draw() override;
 
+    void clear() override;
+
     // modify the display parameters
     // if the size is out of bounds will throw Error("New map size is too big!")
     // or Error("New map size is too small!")
@@ -159,6 +208,7 @@ public:
     void set_origin(Point origin_)
     {
         origin = origin_;
+        frame_valid = false;
     }
 
     // set the parameters to the default values
@@ -169,11 +219,31 @@ private:
     double scale;		// distance per cell of the display
     Point origin;		// coordinates of the lower-left-hand corner
 
+    // The map is kept between draws as a character framebuffer holding the rows, with
+    // their axis labels, and the bottom axis labels, so it can be output with one write.
+    // The cell of each object is remembered, and when an object moves into or out of a
+    // cell, only that cell is rewritten. The whole frame is rebuilt only after the size,
+    // scale, or origin has changed.
+    std::string frame;
+    bool frame_valid;
+    std::vector<int> row_offsets;	// position in the frame of the first cell of each row, by y
+    std::vector<int> cell_counts;	// number of objects in each cell, by y * size + x
+    std::vector<int> cell_id_xors;	// XOR of the IDs of the objects in each cell, which is
+                                    // the ID of the object when there is only one
+    std::vector<int> object_cells;	// cell of each object by ID, or a negative value if none
+
     // Calculate the cell subscripts corresponding to the location parameter, using the
     // current size, scale, and origin of the display.
     // Return true if the location is within the map, false if not
     bool get_subscripts(int &ix, int &iy, Point location);
 
+    // lay out the frame for the current parameters and mark every object present
+    void rebuild_frame();
+    // move the object to the cell of its current location, or take it off the map
+    // if it is not present or outside the map
+    void place_object(int id);
+    // rewrite the frame's characters for the cell
+    void write_cell(int cell);
 };
 
 #endif
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "Warship.h"
+#include "Snapshot.h"
+#include "Combat_engine.h"
 #include <iostream>
+#include <vector>
 #include <cassert>
 
 using namespace std;
@@ -9,22 +12,25 @@ Warship::Warship(const string& name_, Point position_, double fuel_capacity_,
         double maximum_speed_, double fuel_consumption_, int resistance_,
         int firepower_, double maximum_range_) :
         Ship(name_, position_, fuel_capacity_, maximum_speed_, fuel_consumption_, resistance_),
-        firepower(firepower_), max_range(maximum_range_), warship_state(State_warship::NOT_ATTACKING), target()
+        firepower(firepower_), max_range(maximum_range_), warship_state(State_warship::NOT_ATTACKING),
+        auto_attack(false), target()
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Warship " << get_name() << " constructed" << endl;
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Warship " << get_name() << " constructed" << '\n';
 }
 
 // a pure virtual function to mark this as an abstract class,
 // but defined anyway to output destructor message
 Warship::~Warship()
 {
-    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Warship " << get_name() << " destructed" << endl;
+    Combat_engine::get_Instance()->disengage(get_slot());
+    if (SHOW_CONSTRUCTOR_DESTRUCTOR_MSG) cout << "Warship " << get_name() << " destructed" << '\n';
 }
 
 // perform warship-specific behavior
 void Warship::update()
 {
     Ship::update();
+    if (auto_attack && is_afloat()) acquire_nearest_target();
     if (warship_state == State_warship::NOT_ATTACKING) return;
     if (!is_afloat() || target.expired() || !target.lock()->is_afloat())
     {
@@ -32,10 +38,17 @@ void Warship::update()
     }
     else
     {
-        cout << get_name() << " is attacking" << endl;
+        cout << get_name() << " is attacking" << '\n';
     }
 }
 
+// an attacking Warship, or one looking for targets, has an event every hour
+int Warship::get_next_event_delay() const
+{
+    if (warship_state == State_warship::ATTACKING || auto_attack) return 1;
+    return Ship::get_next_event_delay();
+}
+
 // Warships will act on an attack and stop_attack command
 
 // will	throw Error("Cannot attack!") if not Afloat
@@ -49,7 +62,9 @@ void Warship::attack(shared_ptr<Ship> target_ptr_)
     if (target_ptr_ == current_target) throw Error("Already attacking this target!");
     target = target_ptr_;
     warship_state = State_warship::ATTACKING;
-    cout << get_name() << " will attack " << target_ptr_->get_name() << endl;
+    Combat_engine::get_Instance()->engage(get_slot(), target_ptr_->get_slot(), max_range,
+            target_ptr_->get_name() < get_name());
+    cout << get_name() << " will attack " << target_ptr_->get_name() << '\n';
 }
 
 // will throw Error("Was not attacking!") if not Attacking
@@ -58,7 +73,14 @@ void Warship::stop_attack()
     if (warship_state != State_warship::ATTACKING) throw Error("Was not attacking!");
     warship_state = State_warship::NOT_ATTACKING;
     target.reset();
-    cout << get_name() << " stopping attack" << endl;
+    Combat_engine::get_Instance()->disengage(get_slot());
+    cout << get_name() << " stopping attack" << '\n';
+}
+
+// while on, at each update the Warship attacks the nearest afloat ship within range
+void Warship::set_auto_attack(bool auto_attack_)
+{
+    auto_attack = auto_attack_;
 }
 
 void Warship::describe() const
@@ -68,14 +90,62 @@ void Warship::describe() const
     {
         string target_output = "absent ship";
         if (!target.expired()) target_output = target.lock()->get_name();
-        cout << "Attacking " << target_output << endl;
+        cout << "Attacking " << target_output << '\n';
     }
+    if (auto_attack) cout << "Attacking the nearest ship in range" << '\n';
+}
+
+void Warship::save_state(Snapshot_writer& writer) const
+{
+    Ship::save_state(writer);
+    writer.write_int(static_cast<int>(warship_state));
+    writer.write_int(auto_attack);
+    writer.write_string(target.expired() ? "" : target.lock()->get_name());
+}
+void Warship::restore_state(Snapshot_reader& reader)
+{
+    Ship::restore_state(reader);
+    warship_state = static_cast<State_warship>(reader.read_enum(int(State_warship::ATTACKING) + 1));
+    auto_attack = reader.read_int() != 0;
+    string target_name = reader.read_string();
+    if (target_name.empty()) target.reset();
+    else target = Model::get_Instance()->get_ship_ptr(target_name);
+    shared_ptr<Ship> target_ptr = target.lock();
+    if (warship_state == State_warship::ATTACKING && target_ptr)
+        Combat_engine::get_Instance()->engage(get_slot(), target_ptr->get_slot(), max_range, target_name < get_name());
+    else Combat_engine::get_Instance()->disengage(get_slot());
+}
+
+// is the current target in range?
+bool Warship::target_in_range() const
+{
+    if (target.expired()) return false;
+    Model::get_Instance()->bring_up_to_date(*target.lock());
+    return Combat_engine::get_Instance()->is_target_in_range(get_slot());
 }
 
 // fire at the current target
 void Warship::fire_at_target()
 {
-    cout << get_name() << " fires" << endl;
+    cout << get_name() << " fires" << '\n';
     assert(!target.expired());
-    target.lock()->receive_hit(firepower, dynamic_pointer_cast<Ship, Sim_object>(shared_from_this()));
-}
\ No newline at end of file
+    Combat_engine::get_Instance()->fire(dynamic_pointer_cast<Ship, Sim_object>(shared_from_this()), target.lock(), firepower);
+}
+
+// keep attacking the current target while it is afloat and within range; otherwise attack
+// the nearest afloat ship within range. The spatial index is searched only out to the range.
+void Warship::acquire_nearest_target()
+{
+    Model* model = Model::get_Instance();
+    shared_ptr<Ship> current_target = target.lock();
+    if (current_target && current_target->is_afloat())
+    {
+        model->bring_up_to_date(*current_target);
+        if (cartesian_distance(get_location(), current_target->get_location()) < max_range) return;
+    }
+    vector<shared_ptr<Ship>> nearest = model->find_nearest_ships(get_location(), 1,
+            [this](const Ship& ship){return &ship != this && ship.is_afloat();}, max_range);
+    if (nearest.empty() || cartesian_distance(get_location(), nearest.front()->get_location()) >= max_range) return;
+    if (nearest.front() == current_target) return;
+    attack(nearest.front());
+}
@@ -11,6 +11,9 @@
 A Warship is a ship with firepower and range member variables, and some services for
 protected classes to manage many of the details of warship behavior. This is an
 abstract base class, so concrete classes derived from Warship must be declared.
+In auto-attack mode a Warship picks its own targets: at each update it keeps attacking
+its current target while that is afloat and within range, and otherwise attacks the
+nearest afloat ship within range, found with the Model's spatial index.
 */
 
 enum class State_warship {NOT_ATTACKING, ATTACKING};
@@ -23,6 +26,9 @@ public:
 	// perform warship-specific behavior
 	void update() override;
 
+	// an attacking Warship has an event every hour
+	int get_next_event_delay() const override;
+
 	// Warships will act on an attack and stop_attack command
 
 	// will	throw Error("Cannot attack!") if not Afloat
@@ -32,9 +38,16 @@ public:
 
 	// will throw Error("Was not attacking!") if not Attacking
 	void stop_attack() override;
+
+	// while on, at each update the Warship attacks the nearest afloat ship within
+	// its range, unless its current target is still afloat and within range
+	void set_auto_attack(bool auto_attack_) override;
 	
 	void describe() const override;
 
+	void save_state(Snapshot_writer& writer) const override;
+	void restore_state(Snapshot_reader& reader) override;
+
 protected:
 	// initialize, then output constructor message
 	Warship(const std::string& name_, Point position_, double fuel_capacity_,
@@ -50,12 +63,10 @@ protected:
 	// fire at the current target
 	void fire_at_target();
 		
-	// is the current target in range?
-	bool target_in_range() const
-	{
-		if (target.expired()) return false;
-		return cartesian_distance(get_location(), target.lock()->get_location()) < max_range;
-	}
+	// is the current target in range? The Combat_engine decides this for all
+	// attacking Warships at once at the start of each tick of update; in run_until,
+	// the target is brought up to date and checked directly
+	bool target_in_range() const;
 
 	// get the target
 	std::shared_ptr<Ship> get_target() const
@@ -68,8 +79,13 @@ private:
 	double max_range;
 
 	State_warship warship_state;
+	bool auto_attack;
 
 	std::weak_ptr<Ship> target;
+
+	// keep the current target while it is afloat and within range, or else
+	// attack the nearest afloat ship within range
+	void acquire_nearest_target();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "Worker_pool.h"
+#include <cassert>
+
+using namespace std;
+
+// start size - 1 worker threads
+Worker_pool::Worker_pool(int size_) :
+        size(size_), current_task(nullptr), current_n(0), generation(0), chunks_left(0), stopping(false)
+{
+    assert(size > 0);
+    for (int i = 1; i < size; i++)
+        threads.push_back(thread(&Worker_pool::worker_loop, this, i));
+}
+
+// stop and join the worker threads
+Worker_pool::~Worker_pool()
+{
+    {
+        lock_guard<mutex> lock(mtx);
+        stopping = true;
+    }
+    work_ready.notify_all();
+    for (auto&& worker : threads) worker.join();
+}
+
+// divide [0, n) into one chunk per thread, call task(begin, end) on each chunk,
+// and return when all chunks are done
+void Worker_pool::parallel_for(int n, const function<void(int, int)>& task)
+{
+    if (size == 1 || n < size)
+    {
+        task(0, n);
+        return;
+    }
+    {
+        lock_guard<mutex> lock(mtx);
+        current_task = &task;
+        current_n = n;
+        chunks_left = size;
+        ++generation;
+    }
+    work_ready.notify_all();
+    // the calling thread does the first chunk
+    run_chunk(0);
+    unique_lock<mutex> lock(mtx);
+    work_done.wait(lock, [this]{return chunks_left == 0;});
+    current_task = nullptr;
+}
+
+// run chunk number index of the current loop
+void Worker_pool::run_chunk(int index)
+{
+    int begin = int((long(current_n) * index) / size);
+    int end = int((long(current_n) * (index + 1)) / size);
+    (*current_task)(begin, end);
+    lock_guard<mutex> lock(mtx);
+    if (--chunks_left == 0) work_done.notify_one();
+}
+
+// the body of worker thread number index
+void Worker_pool::worker_loop(int index)
+{
+    unsigned long last_generation = 0;
+    while (true)
+    {
+        {
+            unique_lock<mutex> lock(mtx);
+            work_ready.wait(lock, [this, last_generation]{return stopping || generation != last_generation;});
+            if (stopping) return;
+            last_generation = generation;
+        }
+        run_chunk(index);
+    }
+}
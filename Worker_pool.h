@@ -0,0 +1,55 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Worker_pool
+A Worker_pool is a fixed group of threads that share the work of a loop over
+a range of indices. The calling thread takes part in the work, so a pool of size n
+starts n - 1 threads. The threads wait between loops rather than being created
+for each one. A task given to the pool must only touch data belonging to the
+indices it is given.
+*/
+
+class Worker_pool {
+public:
+    // start size - 1 worker threads
+    Worker_pool(int size_);
+    // stop and join the worker threads
+    ~Worker_pool();
+
+    int get_size() const
+        {return size;}
+
+    // divide [0, n) into one chunk per thread, call task(begin, end) on each chunk,
+    // and return when all chunks are done
+    void parallel_for(int n, const std::function<void(int, int)>& task);
+
+    // disallow copy/move construction or assignment
+    Worker_pool(const Worker_pool&) = delete;
+    Worker_pool& operator=(const Worker_pool&) = delete;
+
+private:
+    int size;
+    std::vector<std::thread> threads;
+
+    std::mutex mtx;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+    const std::function<void(int, int)>* current_task;
+    int current_n;
+    unsigned long generation;   // counts the loops started, so each worker runs each loop once
+    int chunks_left;
+    bool stopping;
+
+    // run chunk number index of the current loop
+    void run_chunk(int index);
+    // the body of worker thread number index
+    void worker_loop(int index);
+};
+
+#endif
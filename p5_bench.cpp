@@ -0,0 +1,259 @@
+/*
+Benchmark harness. It builds a synthetic world of islands and of ships of each type,
+then times the hot paths of the program - the Model's update, the drawing of each kind
+of View, and the parsing of commands from the console and from a batch file - and
+reports the time and the number of heap allocations per operation.
+
+Usage: p5bench [ships per type] [islands] [ticks]
+
+All output of the simulation itself is discarded, but it is still formatted, so it is
+included in the times. The times reflect the flags the objects were built with; for
+representative numbers, build with "make clean bench OPTFLAGS=-O2".
+*/
+
+#include "Model.h"
+#include "Controller.h"
+#include "Views.h"
+#include "Ship.h"
+#include "Cruise_ship.h"
+#include "Cruiser.h"
+#include "Island.h"
+#include "Telemetry.h"
+#include "Ship_factory.h"
+#include "Output.h"
+#include "Utility.h"
+#include "Tour_planner.h"
+#include "Logistics.h"
+#include "Profiler.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+const int DEFAULT_SHIPS_PER_TYPE = 100;
+const int DEFAULT_ISLANDS = 20;
+const int DEFAULT_TICKS = 200;
+const int DRAW_REPETITIONS = 100;
+const int PARSE_COMMANDS = 100000;
+const int PLAN_ROUTE_POINTS = 2000;
+// the world is laid out in a square of this width, in nm
+const double WORLD_WIDTH = 200.;
+
+#ifndef PROFILING
+// count every heap allocation made by the program; when profiling is compiled in,
+// the profiler already does
+static atomic<long> allocation_count(0);
+
+void* operator new(size_t size)
+{
+    ++allocation_count;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+long get_allocation_count()
+{
+    return allocation_count;
+}
+#endif
+
+// a stream buffer that discards everything written to it
+class Null_buffer : public streambuf {
+protected:
+    int overflow(int c) override
+        {return c;}
+    streamsize xsputn(const char*, streamsize n) override
+        {return n;}
+};
+
+// time the supplied number of repetitions of the operation and report the mean time and
+// allocations per repetition, and the time per object if objects is positive
+void report(const string& name, int repetitions, int objects, const function<void()>& operation)
+{
+    long allocations_before = get_allocation_count();
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; i++) operation();
+    auto stop = chrono::steady_clock::now();
+    long allocations = get_allocation_count() - allocations_before;
+    double ns = chrono::duration<double, nano>(stop - start).count() / repetitions;
+    fprintf(stderr, "%-16s %10.0f ns/op", name.c_str(), ns);
+    if (objects > 0) fprintf(stderr, " %10.1f ns/object", ns / objects);
+    else fprintf(stderr, " %21s", "");
+    fprintf(stderr, " %10.1f allocs/op\n", double(allocations) / repetitions);
+}
+
+// return a name not in use, which must differ from the others in its first two characters
+string next_free_name(Model* model)
+{
+    static const string letters = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    static size_t next = 0;
+    while (next < letters.size() * letters.size())
+    {
+        string name = string(1, letters[next / letters.size()]) + letters[next % letters.size()] + "_bench";
+        ++next;
+        if (!model->is_name_in_use(name)) return name;
+    }
+    throw Error("Too many objects for distinct names!");
+}
+
+// return a pseudo-random location in the world
+Point random_location()
+{
+    return Point(WORLD_WIDTH * rand() / RAND_MAX, WORLD_WIDTH * rand() / RAND_MAX);
+}
+
+// add the supplied number of ships of each type at pseudo-random locations, and return them
+vector<shared_ptr<Ship>> add_ships(Model* model, int ships_per_type)
+{
+    vector<shared_ptr<Ship>> ships;
+    for (const char* type : {"Tanker", "Cruiser", "Cruise_ship"})
+    {
+        for (int i = 0; i < ships_per_type; i++)
+        {
+            shared_ptr<Ship> ship = create_ship(next_free_name(model), type, random_location());
+            model->add_ship(ship);
+            ships.push_back(ship);
+        }
+    }
+    return ships;
+}
+
+// create a new empty file in the temporary directory, and return its name
+string make_temporary_file(const string& prefix)
+{
+    const char* directory = getenv("TMPDIR");
+    string filename = string(directory && *directory ? directory : "/tmp") + "/" + prefix + "XXXXXX";
+    int fd = mkstemp(&filename[0]);
+    if (fd < 0) throw Error("Could not create temporary file!");
+    close(fd);
+    return filename;
+}
+
+int main(int argc, char* argv[])
+{
+    int ships_per_type = argc > 1 ? atoi(argv[1]) : DEFAULT_SHIPS_PER_TYPE;
+    int island_count = argc > 2 ? atoi(argv[2]) : DEFAULT_ISLANDS;
+    int ticks = argc > 3 ? atoi(argv[3]) : DEFAULT_TICKS;
+
+    init_output();
+    cout.setf(ios::fixed, ios::floatfield);
+    cout.precision(2);
+    Null_buffer null_buffer;
+    streambuf* console_buffer = cout.rdbuf(&null_buffer);
+
+    try
+    {
+        // build the world; the islands come first, since cruise ships learn them when created
+        srand(1);
+        Model* model = Model::get_Instance();
+        for (int i = 0; i < island_count; i++)
+        {
+            model->add_island(make_shared<Island>(next_free_name(model), random_location(), 1000., 10.));
+        }
+        vector<shared_ptr<Ship>> ships = add_ships(model, ships_per_type);
+        // set every ship moving; cruise ships go on a cruise from an island
+        const Model::Island_map& islands = model->get_islands();
+        for (auto&& ship : ships)
+        {
+            if (dynamic_pointer_cast<Cruise_ship>(ship) != nullptr)
+                ship->set_destination_position_and_speed(islands.begin()->second->get_location(), 10.);
+            else ship->set_course_and_speed(360. * rand() / RAND_MAX, 5.);
+        }
+        int object_count = int(ships.size() + islands.size());
+        fprintf(stderr, "%d ships, %d islands, %d ticks\n", int(ships.size()), int(islands.size()), ticks);
+
+        // the views are attached while the ships move, and refreshed before each draw
+        shared_ptr<View_map> map_view = make_shared<View_map>();
+        shared_ptr<View_sail> sail_view = make_shared<View_sail>();
+        shared_ptr<View_bridge> bridge_view = make_shared<View_bridge>(ships.front()->get_name());
+        model->attach(map_view);
+        model->attach(sail_view);
+        model->attach(bridge_view);
+
+        report("update", ticks, object_count, [model](){model->update();});
+        report("draw map", DRAW_REPETITIONS, object_count, [model, map_view](){model->refresh_view(map_view); map_view->draw();});
+        report("draw bridge", DRAW_REPETITIONS, object_count, [model, bridge_view](){model->refresh_view(bridge_view); bridge_view->draw();});
+        report("draw sail", DRAW_REPETITIONS, int(ships.size()), [model, sail_view](){model->refresh_view(sail_view); sail_view->draw();});
+        report("update+draw", ticks, object_count, [model, map_view](){model->update(); model->refresh_view(map_view); map_view->draw();});
+        model->detach(map_view);
+        model->detach(sail_view);
+        model->detach(bridge_view);
+
+        // the same updates while a telemetry log of them is written
+        string telemetry_filename = make_temporary_file("p5bench_telemetry_");
+        shared_ptr<View_telemetry> telemetry_view = make_shared<View_telemetry>(telemetry_filename);
+        model->attach(telemetry_view);
+        report("update+telemetry", ticks, object_count, [model](){model->update();});
+        model->detach(telemetry_view);
+        telemetry_view->close();
+        unlink(telemetry_filename.c_str());
+
+        // plan a cruise route through many more islands than the world has
+        vector<Point> route_points;
+        for (int i = 0; i < PLAN_ROUTE_POINTS; i++) route_points.push_back(random_location());
+        report("plan route", 1, PLAN_ROUTE_POINTS, [&route_points](){plan_tour(route_points, 0);});
+        report("assign tankers", 1, ships_per_type, [](){assign_tanker_routes(24);});
+
+        // every cruiser attacks the ship nearest to it, and the ships fight it out
+        for (auto&& ship : ships)
+        {
+            if (dynamic_pointer_cast<Cruiser>(ship) == nullptr) continue;
+            vector<shared_ptr<Ship>> nearest = model->find_nearest_ships(ship->get_location(), 1,
+                    [&ship](const Ship& other){return &other != ship.get();});
+            if (!nearest.empty()) ship->attack(nearest.front());
+        }
+        report("update in combat", ticks, object_count, [model](){model->update();});
+
+        // the cruisers left then find their own targets
+        for (auto&& ship : ships)
+        {
+            if (dynamic_pointer_cast<Cruiser>(ship) != nullptr && ship->is_afloat()) ship->set_auto_attack(true);
+        }
+        report("auto attack", ticks, object_count, [model](){model->update();});
+
+        // the same ship commands are parsed from the console and from a batch file; they are
+        // given to new ships, since many of those above are sunk or out of fuel by now, and
+        // every command must succeed, so that the times are of parsing and not of errors
+        vector<shared_ptr<Ship>> command_ships = add_ships(model, ships_per_type);
+        ostringstream commands;
+        for (int i = 0; i < PARSE_COMMANDS; i++)
+        {
+            commands << command_ships[i % command_ships.size()]->get_name() << " course " << (i % 360) << ".5 " << (i % 5) << '\n';
+        }
+        string batch_filename = make_temporary_file("p5bench_commands_");
+        ofstream(batch_filename) << commands.str();
+
+        Controller controller;
+        streambuf* console_input = cin.rdbuf();
+        istringstream console_commands(commands.str() + "quit\n");
+        cin.rdbuf(console_commands.rdbuf());
+        report("parse console", 1, PARSE_COMMANDS, [&controller](){controller.run();});
+        istringstream batch_command("batch " + batch_filename + "\nquit\n");
+        cin.rdbuf(batch_command.rdbuf());
+        report("parse batch", 1, PARSE_COMMANDS, [&controller](){controller.run();});
+        cin.rdbuf(console_input);
+        unlink(batch_filename.c_str());
+        if (controller.get_error_count() > 0) throw Error("Some of the parsed commands failed!");
+    }
+    catch (exception& e)
+    {
+        cout.rdbuf(console_buffer);
+        cout << e.what() << endl;
+        return 1;
+    }
+    cout.rdbuf(console_buffer);
+}